@@ -37,4 +37,16 @@ void LoadWindowIcon()
 }
 #endif //BUILD_WITH_SOKOL_APP
 
-#endif //BUILD_WITH_SOKOL_GFX
\ No newline at end of file
+#endif //BUILD_WITH_SOKOL_GFX
+
+// Centers the view on the search result's node and closes the search box.
+// Returns false if the node was removed since the search ran
+bool JumpToSearchResult(uxx resultIndex)
+{
+	Assert(resultIndex < app->numSearchResults);
+	TreeNode* node = GetTreeNodeByHandle(&app->tree, app->searchResults[resultIndex].node);
+	if (node == nullptr) { return false; }
+	app->viewPosition = GetTreeNodePosition(&app->tree, node);
+	app->isSearchFocused = false;
+	return true;
+}
@@ -0,0 +1,144 @@
+/*
+File:   app_id_table.c
+Author: Taylor Robbins
+Date:   10\16\2026
+Description: 
+	** Holds the API for IdTable, a small uxx -> uxx hash table that we use to
+	** lookup things like TreeNode slots by id in constant time
+*/
+
+void FreeIdTable(IdTable* table)
+{
+	NotNull(table);
+	if (table->arena != nullptr && table->slots != nullptr)
+	{
+		FreeArray(IdTableSlot, table->arena, table->capacity, table->slots);
+	}
+	ClearPointer(table);
+}
+
+void InitIdTable(Arena* arena, IdTable* tableOut)
+{
+	NotNull(arena);
+	NotNull(tableOut);
+	ClearPointer(tableOut);
+	tableOut->arena = arena;
+}
+
+// Fibonacci hashing spreads sequential ids (which is what we get from nextNodeId) evenly across the table
+uxx GetIdTableHomeIndex(const IdTable* table, uxx key)
+{
+	u64 hash = ((u64)key * 11400714819323198485ULL);
+	hash ^= (hash >> 32);
+	return (uxx)(hash & (u64)(table->capacity - 1));
+}
+
+void ClearIdTable(IdTable* table)
+{
+	NotNull(table);
+	if (table->slots != nullptr) { MyMemSet(table->slots, 0x00, sizeof(IdTableSlot) * table->capacity); }
+	table->count = 0;
+}
+
+bool IdTableFind(const IdTable* table, uxx key, uxx* valueOut)
+{
+	NotNull(table);
+	Assert(key != ID_TABLE_EMPTY_KEY);
+	if (table->count == 0) { return false; }
+	uxx index = GetIdTableHomeIndex(table, key);
+	while (true)
+	{
+		const IdTableSlot* slot = &table->slots[index];
+		if (slot->key == key) { SetOptionalOutPntr(valueOut, slot->value); return true; }
+		if (slot->key == ID_TABLE_EMPTY_KEY) { return false; }
+		index = ((index + 1) & (table->capacity - 1));
+	}
+}
+
+void IdTableResize(IdTable* table, uxx newCapacity)
+{
+	NotNull(table);
+	NotNull(table->arena);
+	Assert(newCapacity >= ID_TABLE_MIN_CAPACITY && (newCapacity & (newCapacity - 1)) == 0);
+	Assert(table->count * ID_TABLE_MAX_LOAD_DENOM <= newCapacity * ID_TABLE_MAX_LOAD_NUMER);
+	IdTableSlot* oldSlots = table->slots;
+	uxx oldCapacity = table->capacity;
+	table->slots = AllocArray(IdTableSlot, table->arena, newCapacity);
+	NotNull(table->slots);
+	MyMemSet(table->slots, 0x00, sizeof(IdTableSlot) * newCapacity);
+	table->capacity = newCapacity;
+	for (uxx sIndex = 0; sIndex < oldCapacity; sIndex++)
+	{
+		if (oldSlots[sIndex].key == ID_TABLE_EMPTY_KEY) { continue; }
+		uxx index = GetIdTableHomeIndex(table, oldSlots[sIndex].key);
+		while (table->slots[index].key != ID_TABLE_EMPTY_KEY) { index = ((index + 1) & (table->capacity - 1)); }
+		table->slots[index] = oldSlots[sIndex];
+	}
+	if (oldSlots != nullptr) { FreeArray(IdTableSlot, table->arena, oldCapacity, oldSlots); }
+}
+
+// Makes sure we can hold numItems without needing to grow in the middle of a bunch of inserts
+void IdTableReserve(IdTable* table, uxx numItems)
+{
+	NotNull(table);
+	uxx newCapacity = (table->capacity > 0) ? table->capacity : ID_TABLE_MIN_CAPACITY;
+	while (numItems * ID_TABLE_MAX_LOAD_DENOM > newCapacity * ID_TABLE_MAX_LOAD_NUMER) { newCapacity *= 2; }
+	if (newCapacity != table->capacity) { IdTableResize(table, newCapacity); }
+}
+
+// Inserts the key or overwrites the value if the key is already present
+void IdTableSet(IdTable* table, uxx key, uxx value)
+{
+	NotNull(table);
+	Assert(key != ID_TABLE_EMPTY_KEY);
+	IdTableReserve(table, table->count + 1);
+	uxx index = GetIdTableHomeIndex(table, key);
+	while (true)
+	{
+		IdTableSlot* slot = &table->slots[index];
+		if (slot->key == key) { slot->value = value; return; }
+		if (slot->key == ID_TABLE_EMPTY_KEY)
+		{
+			slot->key = key;
+			slot->value = value;
+			table->count++;
+			return;
+		}
+		index = ((index + 1) & (table->capacity - 1));
+	}
+}
+
+bool IdTableRemove(IdTable* table, uxx key)
+{
+	NotNull(table);
+	Assert(key != ID_TABLE_EMPTY_KEY);
+	if (table->count == 0) { return false; }
+	uxx mask = table->capacity - 1;
+	uxx index = GetIdTableHomeIndex(table, key);
+	while (table->slots[index].key != key)
+	{
+		if (table->slots[index].key == ID_TABLE_EMPTY_KEY) { return false; }
+		index = ((index + 1) & mask);
+	}
+	
+	// Backward-shift deletion: pull later entries of the cluster back into the hole
+	// as long as doing so doesn't move them in front of their home index
+	uxx holeIndex = index;
+	uxx nextIndex = ((holeIndex + 1) & mask);
+	while (table->slots[nextIndex].key != ID_TABLE_EMPTY_KEY)
+	{
+		uxx homeIndex = GetIdTableHomeIndex(table, table->slots[nextIndex].key);
+		uxx distFromHome = ((nextIndex - homeIndex) & mask);
+		uxx distFromHole = ((nextIndex - holeIndex) & mask);
+		if (distFromHome >= distFromHole)
+		{
+			table->slots[holeIndex] = table->slots[nextIndex];
+			holeIndex = nextIndex;
+		}
+		nextIndex = ((nextIndex + 1) & mask);
+	}
+	table->slots[holeIndex].key = ID_TABLE_EMPTY_KEY;
+	table->slots[holeIndex].value = 0;
+	table->count--;
+	return true;
+}
@@ -0,0 +1,35 @@
+/*
+File:   app_id_table.h
+Author: Taylor Robbins
+Date:   10\16\2026
+*/
+
+#ifndef _APP_ID_TABLE_H
+#define _APP_ID_TABLE_H
+
+// Key 0 is reserved to mark an empty slot, which works out since TreeNode ids start at 1
+#define ID_TABLE_EMPTY_KEY       0
+#define ID_TABLE_MIN_CAPACITY    16
+// The table grows once it would be more than 3/4 full
+#define ID_TABLE_MAX_LOAD_NUMER  3
+#define ID_TABLE_MAX_LOAD_DENOM  4
+
+typedef struct IdTableSlot IdTableSlot;
+struct IdTableSlot
+{
+	uxx key;
+	uxx value;
+};
+
+// An open-addressed (linear probing) hash table that maps uxx keys to uxx values.
+// Removal uses backward-shift deletion so we never have tombstones clogging up the probe sequences
+typedef struct IdTable IdTable;
+struct IdTable
+{
+	Arena* arena;
+	uxx count;
+	uxx capacity; //always a power of 2 (or 0 before the first insert)
+	IdTableSlot* slots;
+};
+
+#endif //  _APP_ID_TABLE_H
@@ -30,7 +30,19 @@ Description:
 // +--------------------------------------------------------------+
 #include "platform_interface.h"
 #include "main2d_shader.glsl.h"
+#include "app_id_table.h"
+#include "app_str_pool.h"
+#include "app_trigram_index.h"
 #include "app_tree.h"
+#include "app_tree_undo.h"
+#include "app_tree_reach.h"
+#include "app_tree_snapshot.h"
+#include "app_tree_diff.h"
+#include "app_tree_merge.h"
+#include "app_tree_path.h"
+#include "app_tree_communities.h"
+#include "app_tree_similar.h"
+#include "app_tree_chain.h"
 #include "app_main.h"
 
 // +--------------------------------------------------------------+
@@ -49,7 +61,19 @@ static Arena* stdHeap = nullptr;
 // |                         Source Files                         |
 // +--------------------------------------------------------------+
 #include "app_helpers.c"
+#include "app_id_table.c"
+#include "app_str_pool.c"
+#include "app_trigram_index.c"
 #include "app_tree.c"
+#include "app_tree_undo.c"
+#include "app_tree_reach.c"
+#include "app_tree_snapshot.c"
+#include "app_tree_diff.c"
+#include "app_tree_merge.c"
+#include "app_tree_path.c"
+#include "app_tree_communities.c"
+#include "app_tree_similar.c"
+#include "app_tree_chain.c"
 #include "app_clay_widgets.c"
 
 // +==============================+
@@ -156,11 +180,26 @@ EXPORT_FUNC(AppInit) APP_INIT_DEF(AppInit)
 	AddTreeBranch(&app->tree, TreeBranchType_Dependency, Str8_Empty, winAudioId, handmadeHeroNodeId);
 	
 	BakeTreeReferences(&app->tree);
-	VarArrayLoop(&app->tree.nodes, nIndex)
+	InitTreeUndoJournal(stdHeap, TREE_UNDO_BUDGET, &app->undo);
+	InitTreeSnapshotPublisher(stdHeap, &app->snapshots);
+	InitTreeCommunities(stdHeap, &app->snapshots, &app->communities);
+	InitTreeSimilarIndex(stdHeap, &app->similarProjects);
+	InitTreeReachIndex(stdHeap, &app->dependencyReach);
+	InitTreeChainCache(stdHeap, &app->dependencyReach, &app->hoveredChains);
+	UpdateTreeReachIndex(&app->dependencyReach, &app->tree); //a full pass, fine while loading. Chains only read it until the next Dependency edit
+	InitVarArray(TreeNodeHandle, &app->pathNodes, stdHeap);
+	InitVarArray(TreeBranchHandle, &app->pathBranches, stdHeap);
+	InitVarArray(u64, &app->pathNodeBits, stdHeap);
+	InitVarArray(u64, &app->pathBranchBits, stdHeap);
+	// Positions are part of each node's hash, so these go through SetTreeNodePosition rather than the positions view
+	TreeNodeView initialNodes = GetTreeNodesView(&app->tree);
+	for (uxx nIndex = 0; nIndex < initialNodes.count; nIndex++)
 	{
-		VarArrayLoopGet(TreeNode, node, &app->tree.nodes, nIndex);
-		node->position.X = GetRandR32Range(&app->random, -100, 100);
-		node->position.Y = GetRandR32Range(&app->random, -100, 100);
+		const TreeNode* node = &TreeViewAt(initialNodes, nIndex);
+		if (!IsTreeSlotGenerationAlive(node->generation)) { continue; } //free slot
+		r32 positionX = GetRandR32Range(&app->random, -100, 100);
+		r32 positionY = GetRandR32Range(&app->random, -100, 100);
+		SetTreeNodePosition(&app->tree, node, NewV2(positionX, positionY));
 	}
 	
 	app->initialized = true;
@@ -214,24 +253,27 @@ EXPORT_FUNC(AppUpdate) APP_UPDATE_DEF(AppUpdate)
 	// +==============================+
 	// |      Find Hovered Node       |
 	// +==============================+
-	app->hoveredNode = nullptr;
+	app->hoveredNode = TreeNodeHandle_Empty;
 	if (app->isMovingNode)
 	{
-		app->hoveredNode = GetTreeNodeById(&app->tree, app->movingNodeId);
+		app->hoveredNode = GetTreeNodeHandle(&app->tree, GetTreeNodeById(&app->tree, app->movingNodeId));
 	}
 	else if (IsInsideRec(viewportRec, mousePos)) //TODO: Somehow we need to know if the mouse is over something else that is overlapping with the viewport!
 	{
 		app->graphBounds = Rec_Zero;
-		VarArrayLoop(&app->tree.nodes, nIndex)
+		bool isFirstNode = true;
+		TreeIdView nodeIds = GetTreeNodeIdsView(&app->tree);
+		TreeNodeView nodes = GetTreeNodesView(&app->tree);
+		TreeBitsLoop(&app->tree.visibleNodeBits, nIndex)
 		{
-			VarArrayLoopGet(TreeNode, node, &app->tree.nodes, nIndex);
-			ClayId nodeClayId = ToClayIdPrint("Node%llu", (u64)node->id);
+			ClayId nodeClayId = ToClayIdPrint("Node%llu", (u64)TreeViewAt(nodeIds, nIndex));
 			rec nodeDrawRec = GetClayElementDrawRec(nodeClayId);
-			if (nIndex == 0) { app->graphBounds = nodeDrawRec; }
+			if (isFirstNode) { app->graphBounds = nodeDrawRec; isFirstNode = false; }
 			else { app->graphBounds = BothRec(app->graphBounds, nodeDrawRec); }
 			if (IsInsideRec(nodeDrawRec, mousePos))
 			{
-				app->hoveredNode = node;
+				app->hoveredNode.index = (u32)nIndex;
+				app->hoveredNode.generation = TreeViewAt(nodes, nIndex).generation;
 			}
 		}
 	}
@@ -242,16 +284,19 @@ EXPORT_FUNC(AppUpdate) APP_UPDATE_DEF(AppUpdate)
 	if (viewportRecReady)
 	{
 		app->graphBounds = Rec_Zero;
-		VarArrayLoop(&app->tree.nodes, nIndex)
+		bool isFirstNode = true;
+		TreeIdView nodeIds = GetTreeNodeIdsView(&app->tree);
+		TreePositionView nodePositions = GetTreeNodePositionsView(&app->tree);
+		TreeBitsLoop(&app->tree.visibleNodeBits, nIndex)
 		{
-			VarArrayLoopGet(TreeNode, node, &app->tree.nodes, nIndex);
-			ClayId nodeClayId = ToClayIdPrint("Node%llu", (u64)node->id);
-			ClayId nodeNameIdStr = ToClayIdPrint("Node%lluName", (u64)node->id);
+			uxx nodeId = TreeViewAt(nodeIds, nIndex);
+			ClayId nodeClayId = ToClayIdPrint("Node%llu", (u64)nodeId);
+			ClayId nodeNameIdStr = ToClayIdPrint("Node%lluName", (u64)nodeId);
 			rec nodeUiRec = GetClayElementDrawRec(nodeClayId);
 			rec nodeNameUiRec = GetClayElementDrawRec(nodeNameIdStr);
-			rec nodeRec = NewRecCenteredV(node->position, nodeUiRec.Size);
+			rec nodeRec = NewRecCenteredV(TreeViewAt(nodePositions, nIndex), nodeUiRec.Size);
 			rec nameRec = NewRecV(Add(nodeRec.TopLeft, Sub(nodeNameUiRec.TopLeft, nodeUiRec.TopLeft)), nodeNameUiRec.Size);
-			if (nIndex == 0) { app->graphBounds = nodeRec; }
+			if (isFirstNode) { app->graphBounds = nodeRec; isFirstNode = false; }
 			else { app->graphBounds = BothRec(app->graphBounds, nodeRec); }
 			app->graphBounds = BothRec(app->graphBounds, nameRec);
 		}
@@ -260,18 +305,20 @@ EXPORT_FUNC(AppUpdate) APP_UPDATE_DEF(AppUpdate)
 	// +==============================+
 	// |    Move Nodes With Mouse     |
 	// +==============================+
-	if (app->hoveredNode != nullptr && !app->isMovingNode)
+	TreeNode* hoveredNode = GetTreeNodeByHandle(&app->tree, app->hoveredNode);
+	if (hoveredNode != nullptr && !app->isMovingNode)
 	{
 		if (IsMouseBtnPressed(&appIn->mouse, MouseBtn_Left))
 		{
-			ClayId nodeClayId = ToClayIdPrint("Node%llu", (u64)app->hoveredNode->id);
+			ClayId nodeClayId = ToClayIdPrint("Node%llu", (u64)hoveredNode->id);
 			rec nodeDrawRec = GetClayElementDrawRec(nodeClayId);
 			if (nodeDrawRec.Width > 0 && nodeDrawRec.Height > 0)
 			{
 				v2 nodeCenter = Add(nodeDrawRec.TopLeft, Div(nodeDrawRec.Size, 2.0f));
 				app->isMovingNode = true;
 				app->movingNodeGrabOffset = Sub(mousePos, nodeCenter);
-				app->movingNodeId = app->hoveredNode->id;
+				app->movingNodeId = hoveredNode->id;
+				app->movingNodeStartPos = GetTreeNodePosition(&app->tree, hoveredNode);
 			}
 		}
 	}
@@ -281,15 +328,137 @@ EXPORT_FUNC(AppUpdate) APP_UPDATE_DEF(AppUpdate)
 		if (movingNode == nullptr) { app->isMovingNode = false; }
 		else if (viewportRecReady)
 		{
-			if (!IsMouseBtnDown(&appIn->mouse, MouseBtn_Left)) { app->isMovingNode = false; }
+			if (!IsMouseBtnDown(&appIn->mouse, MouseBtn_Left))
+			{
+				app->isMovingNode = false;
+				RecordTreeNodeMove(&app->undo, app->movingNodeId, app->movingNodeStartPos, GetTreeNodePosition(&app->tree, movingNode));
+			}
 			else
 			{
 				v2 newPosition = Add(Sub(Sub(Sub(mousePos, app->movingNodeGrabOffset), viewportRec.TopLeft), viewportHalfSize), app->viewPosition);
-				movingNode->position = newPosition;
+				SetTreeNodePosition(&app->tree, movingNode, newPosition);
 			}
 		}
 	}
 	
+	// +==============================+
+	// |  Right Click Learning Path   |
+	// +==============================+
+	if (!app->isMovingNode && IsMouseBtnPressed(&appIn->mouse, MouseBtn_Right) && IsInsideRec(viewportRec, mousePos))
+	{
+		if (hoveredNode == nullptr) { app->pathStartId = 0; app->pathEndId = 0; }
+		else if (app->pathStartId == 0 || app->pathEndId != 0) { app->pathStartId = hoveredNode->id; app->pathEndId = 0; }
+		else { app->pathEndId = hoveredNode->id; }
+		app->pathDirty = true;
+	}
+	if (app->pathDirty || (app->pathEndId != 0 && app->pathTreeVersion != app->tree.snapshotVersion))
+	{
+		VarArrayLoop(&app->pathNodes, pIndex) { VarArrayLoopGet(TreeNodeHandle, pathNode, &app->pathNodes, pIndex); SetTreeBit(&app->pathNodeBits, pathNode->index, false); }
+		VarArrayLoop(&app->pathBranches, pIndex) { VarArrayLoopGet(TreeBranchHandle, pathBranch, &app->pathBranches, pIndex); SetTreeBit(&app->pathBranchBits, pathBranch->index, false); }
+		VarArrayClear(&app->pathNodes, false);
+		VarArrayClear(&app->pathBranches, false);
+		app->pathFound = false;
+		if (app->pathEndId != 0)
+		{
+			TreePathCosts pathCosts = GetDefaultTreePathCosts();
+			app->pathFound = FindTreePath(&app->tree, app->pathStartId, app->pathEndId, &pathCosts, &app->pathNodes, &app->pathBranches, nullptr);
+			VarArrayLoop(&app->pathNodes, pIndex) { VarArrayLoopGet(TreeNodeHandle, pathNode, &app->pathNodes, pIndex); SetTreeBit(&app->pathNodeBits, pathNode->index, true); }
+			VarArrayLoop(&app->pathBranches, pIndex) { VarArrayLoopGet(TreeBranchHandle, pathBranch, &app->pathBranches, pIndex); SetTreeBit(&app->pathBranchBits, pathBranch->index, true); }
+		}
+		app->pathTreeVersion = app->tree.snapshotVersion;
+		app->pathDirty = false;
+	}
+	
+	// +==============================+
+	// |  Press L to Mark as Learned  |
+	// +==============================+
+	if (hoveredNode != nullptr && !app->isMovingNode && !app->isSearchFocused && IsKeyboardKeyPressed(&appIn->keyboard, Key_L))
+	{
+		SetTreeNodeLearned(&app->tree, hoveredNode, !IsTreeNodeLearned(&app->tree, hoveredNode));
+	}
+	
+	// +==============================+
+	// |  Similar Projects on Hover   |
+	// +==============================+
+	TreeNodeHandle similarHandle = (hoveredNode != nullptr && !app->isMovingNode && hoveredNode->type == TreeNodeType_Project) ? app->hoveredNode : TreeNodeHandle_Empty;
+	if (!AreEqualTreeNodeHandles(similarHandle, app->similarNode) || app->similarRefsVersion != app->tree.refsVersion)
+	{
+		app->similarNode = similarHandle;
+		app->numSimilarResults = 0;
+		if (!IsEmptyTreeNodeHandle(similarHandle)) { app->numSimilarResults = FindSimilarTreeNodes(&app->similarProjects, &app->tree, hoveredNode, SIMILAR_PANEL_MAX_RESULTS, &app->similarResults[0]); }
+		app->similarRefsVersion = app->tree.refsVersion;
+	}
+	
+	// +==============================+
+	// |    Node Search with Ctrl+F   |
+	// +==============================+
+	if (IsMouseBtnPressed(&appIn->mouse, MouseBtn_Left))
+	{
+		app->isSearchFocused = (IsMouseOverClay(CLAY_ID("SearchBox")) || (app->isSearchFocused && IsMouseOverClay(CLAY_ID("SearchResults"))));
+	}
+	if (IsKeyboardKeyDown(&appIn->keyboard, Key_Control) && IsKeyboardKeyPressed(&appIn->keyboard, Key_F)) { app->isSearchFocused = true; }
+	if (app->isSearchFocused)
+	{
+		bool searchChanged = false;
+		for (uxx cIndex = 0; cIndex < appIn->keyboard.numCharInputs; cIndex++)
+		{
+			u32 codepoint = appIn->keyboard.charInputs[cIndex].codepoint;
+			if (codepoint < ' ' || codepoint == 0x7F) { continue; }
+			u8 encodedBytes[UTF8_MAX_CHAR_SIZE];
+			u8 numEncodedBytes = GetUtf8BytesForCode(codepoint, &encodedBytes[0], false);
+			if (numEncodedBytes == 0 || app->searchLength + numEncodedBytes > NODE_SEARCH_MAX_LENGTH) { continue; }
+			MyMemCopy(&app->searchBuffer[app->searchLength], &encodedBytes[0], numEncodedBytes);
+			app->searchLength += numEncodedBytes;
+			searchChanged = true;
+		}
+		if (IsKeyboardKeyPressed(&appIn->keyboard, Key_Backspace) && app->searchLength > 0)
+		{
+			// Remove the whole last character, not just its last UTF-8 byte
+			app->searchLength--;
+			while (app->searchLength > 0 && ((u8)app->searchBuffer[app->searchLength] & 0xC0) == 0x80) { app->searchLength--; }
+			searchChanged = true;
+		}
+		if (searchChanged)
+		{
+			app->numSearchResults = SearchTreeNodes(&app->tree, NewStr8(app->searchLength, &app->searchBuffer[0]), NODE_SEARCH_MAX_RESULTS, &app->searchResults[0]);
+			app->selectedSearchResult = 0;
+		}
+		if (app->numSearchResults > 0)
+		{
+			if (IsKeyboardKeyPressed(&appIn->keyboard, Key_Down)) { app->selectedSearchResult = (app->selectedSearchResult + 1) % app->numSearchResults; }
+			if (IsKeyboardKeyPressed(&appIn->keyboard, Key_Up)) { app->selectedSearchResult = (app->selectedSearchResult + app->numSearchResults - 1) % app->numSearchResults; }
+			if (app->selectedSearchResult >= app->numSearchResults) { app->selectedSearchResult = 0; }
+			if (IsKeyboardKeyPressed(&appIn->keyboard, Key_Enter)) { JumpToSearchResult(app->selectedSearchResult); }
+		}
+		if (IsKeyboardKeyPressed(&appIn->keyboard, Key_Escape)) { app->isSearchFocused = false; }
+	}
+	
+	// +==============================+
+	// |   Ctrl+Z Undo / Ctrl+Y Redo  |
+	// +==============================+
+	if (!app->isMovingNode && !app->isSearchFocused && IsKeyboardKeyDown(&appIn->keyboard, Key_Control))
+	{
+		if (IsKeyboardKeyPressed(&appIn->keyboard, Key_Z))
+		{
+			if (IsKeyboardKeyDown(&appIn->keyboard, Key_Shift)) { RedoTreeEdit(&app->undo, &app->tree); }
+			else { UndoTreeEdit(&app->undo, &app->tree); }
+		}
+		else if (IsKeyboardKeyPressed(&appIn->keyboard, Key_Y)) { RedoTreeEdit(&app->undo, &app->tree); }
+	}
+	
+	// All of this frame's edits are done, anything reading the tree from another thread sees them from here on
+	PublishTreeSnapshot(&app->snapshots, &app->tree);
+	
+	// Picks up the colors from the last community job (if it's done) and queues another one if a node or branch was added/removed since.
+	// Without threads (like on the web) the job runs right here instead, which is slower but only happens after an edit
+	if (UpdateTreeCommunities(&app->communities, &app->tree))
+	{
+		if (!platform->QueueWorkerJob(&app->communities.job)) { app->communities.job.function(app->communities.job.contextPntr); }
+	}
+	
+	// Only looks up the chain when the hovered node (or the Dependencies) changed, and walking big chains is spread over a few frames
+	UpdateTreeChainHighlight(&app->hoveredChains, &app->tree, app->hoveredNode, CHAIN_HIGHLIGHT_FRAME_BUDGET);
+	
 	// +--------------------------------------------------------------+
 	// |                            Render                            |
 	// +--------------------------------------------------------------+
@@ -345,6 +514,116 @@ EXPORT_FUNC(AppUpdate) APP_UPDATE_DEF(AppUpdate)
 						Clay__CloseElement();
 						Clay__CloseElement();
 					} Clay__CloseElement();
+					
+					if (ClayTopBtn("View", false, &app->isViewMenuOpen, &app->keepViewMenuOpenUntilMouseOver, false))
+					{
+						u8 visibleNodeTypes = app->tree.visibleNodeTypes;
+						u8 visibleBranchTypes = app->tree.visibleBranchTypes;
+						for (uxx tIndex = 1; tIndex < TreeNodeType_Count; tIndex++)
+						{
+							bool isVisible = IsFlagSet(visibleNodeTypes, TreeNodeTypeFlag(tIndex));
+							Str8 btnIdStr = PrintInArenaStr(scratch, "ViewNodeType%llu", (u64)tIndex);
+							if (ClayBtnStrEx(btnIdStr, StrLit(GetTreeNodeTypeStr((TreeNodeType)tIndex)), isVisible ? StrLit("Shown") : StrLit("Hidden"), true, nullptr))
+							{
+								visibleNodeTypes ^= TreeNodeTypeFlag(tIndex);
+							} Clay__CloseElement();
+						}
+						for (uxx tIndex = 1; tIndex < TreeBranchType_Count; tIndex++)
+						{
+							bool isVisible = IsFlagSet(visibleBranchTypes, TreeBranchTypeFlag(tIndex));
+							Str8 btnIdStr = PrintInArenaStr(scratch, "ViewBranchType%llu", (u64)tIndex);
+							if (ClayBtnStrEx(btnIdStr, StrLit(GetTreeBranchTypeStr((TreeBranchType)tIndex)), isVisible ? StrLit("Shown") : StrLit("Hidden"), true, nullptr))
+							{
+								visibleBranchTypes ^= TreeBranchTypeFlag(tIndex);
+							} Clay__CloseElement();
+						}
+						SetTreeVisibleTypes(&app->tree, visibleNodeTypes, visibleBranchTypes);
+						if (ClayBtnStrEx(StrLit("ViewStatsPanel"), StrLit("Stats"), app->isStatsPanelOpen ? StrLit("Shown") : StrLit("Hidden"), true, nullptr))
+						{
+							app->isStatsPanelOpen = !app->isStatsPanelOpen;
+						} Clay__CloseElement();
+						
+						Clay__CloseElement();
+						Clay__CloseElement();
+					} Clay__CloseElement();
+					
+					CLAY({ .layout = { .sizing = { .width = CLAY_SIZING_GROW(0) } } }) {}
+					
+					Str8 treeMemoryStr = PrintInArenaStr(scratch, "%llu nodes, %.1fMB", (u64)app->tree.numNodes, (r64)GetSkillTreeBytesUsed(&app->tree) / (r64)Megabytes(1));
+					if (app->pathEndId != 0)
+					{
+						Str8 pathStr = app->pathFound ? PrintInArenaStr(scratch, "Path: %llu steps", (u64)app->pathBranches.length) : StrLit("No path");
+						treeMemoryStr = PrintInArenaStr(scratch, "%.*s, %.*s", StrPrint(pathStr), StrPrint(treeMemoryStr));
+					}
+					CLAY_TEXT(
+						ToClayString(treeMemoryStr),
+						CLAY_TEXT_CONFIG({
+							.fontId = app->clayUiFontId,
+							.fontSize = (u16)UI_FONT_SIZE,
+							.textColor = ToClayColor(UiTextGray),
+							.wrapMode = CLAY_TEXT_WRAP_NONE,
+						})
+					);
+					
+					Str8 searchStr = NewStr8(app->searchLength, &app->searchBuffer[0]);
+					CLAY({ .id = CLAY_ID("SearchBox"),
+						.layout = {
+							.sizing = { .width = CLAY_SIZING_FIXED(NODE_SEARCH_BOX_WIDTH), .height = CLAY_SIZING_FIT(0) },
+							.padding = { 4, 4, 2, 2 },
+						},
+						.backgroundColor = ToClayColor(UiBackgroundBlack),
+						.cornerRadius = CLAY_CORNER_RADIUS(4),
+						.border = { .width=CLAY_BORDER_OUTSIDE(1), .color=ToClayColor(app->isSearchFocused ? UiSelectedBlue : UiOutlineGray) },
+					})
+					{
+						CLAY_TEXT(
+							ToClayString(IsEmptyStr(searchStr) ? StrLit("Search nodes (Ctrl+F)") : searchStr),
+							CLAY_TEXT_CONFIG({
+								.fontId = app->clayUiFontId,
+								.fontSize = (u16)UI_FONT_SIZE,
+								.textColor = ToClayColor(IsEmptyStr(searchStr) ? UiTextGray : UiTextWhite),
+								.wrapMode = CLAY_TEXT_WRAP_NONE,
+								.textAlignment = CLAY_TEXT_ALIGN_SHRINK,
+								.userData = { .contraction = TextContraction_ClipRight },
+							})
+						);
+						
+						if (app->isSearchFocused && app->numSearchResults > 0)
+						{
+							CLAY({ .id = CLAY_ID("SearchResults"),
+								.floating = {
+									.attachTo = CLAY_ATTACH_TO_PARENT,
+									.zIndex = 5,
+									.attachPoints = { .parent = CLAY_ATTACH_POINT_LEFT_BOTTOM },
+								},
+								.layout = {
+									.layoutDirection = CLAY_TOP_TO_BOTTOM,
+									.sizing = { .width = CLAY_SIZING_FIXED(NODE_SEARCH_BOX_WIDTH) },
+									.padding = { 1, 1, 2, 2 },
+									.childGap = 2,
+								},
+								.backgroundColor = ToClayColor(UiBackgroundGray),
+								.border = { .color=ToClayColor(UiOutlineGray), .width={ .bottom=1 } },
+								.cornerRadius = { 0, 0, 4, 4 },
+							})
+							{
+								for (uxx rIndex = 0; rIndex < app->numSearchResults; rIndex++)
+								{
+									TreeNode* resultNode = GetTreeNodeByHandle(&app->tree, app->searchResults[rIndex].node);
+									if (resultNode == nullptr) { continue; } //removed since the search ran
+									Str8 resultIdStr = PrintInArenaStr(scratch, "SearchResult%llu", (u64)rIndex);
+									bool isSelected = (rIndex == app->selectedSearchResult);
+									CLAY({ .backgroundColor = ToClayColor(isSelected ? UiHoveredBlue : Transparent), .cornerRadius = CLAY_CORNER_RADIUS(4), .layout = { .sizing = { .width = CLAY_SIZING_GROW(0) } } })
+									{
+										if (ClayBtnStrEx(resultIdStr, GetTreeNodeName(&app->tree, resultNode), StrLit(GetTreeNodeTypeStr(resultNode->type)), true, nullptr))
+										{
+											JumpToSearchResult(rIndex);
+										} Clay__CloseElement();
+									}
+								}
+							}
+						}
+					}
 				}
 				
 				// +==============================+
@@ -360,16 +639,24 @@ EXPORT_FUNC(AppUpdate) APP_UPDATE_DEF(AppUpdate)
 					// +==============================+
 					if (viewportRecReady)
 					{
-						VarArrayLoop(&app->tree.branches, bIndex)
+						TreeBranchView branches = GetTreeBranchesView(&app->tree);
+						TreePositionView nodePositions = GetTreeNodePositionsView(&app->tree);
+						TreeBitsLoop(&app->tree.visibleBranchBits, bIndex)
 						{
-							VarArrayLoopGet(TreeBranch, branch, &app->tree.branches, bIndex);
-							if (branch->fromPntr != nullptr && branch->toPntr != nullptr)
+							TreeBranch* branch = &TreeViewAt(branches, bIndex);
+							TreeNode* fromNode = GetTreeNodeByHandle(&app->tree, branch->fromHandle);
+							TreeNode* toNode = GetTreeNodeByHandle(&app->tree, branch->toHandle);
+							if (fromNode != nullptr && toNode != nullptr && IsTreeNodeVisible(&app->tree, branch->fromHandle.index) && IsTreeNodeVisible(&app->tree, branch->toHandle.index))
 							{
 								// Str8 fromNodeUiIdStr = PrintInArenaStr(scratch, "Node%llu", (u64)branch->fromId);
 								// Str8 toNodeUiIdStr = PrintInArenaStr(scratch, "Node%llu", (u64)branch->toId);
-								v2 startPos = Add(Add(branch->fromPntr->position, viewportOffset), viewportRec.TopLeft);
-								v2 endPos = Add(Add(branch->toPntr->position, viewportOffset), viewportRec.TopLeft);
-								DrawLine(startPos, endPos, 3.0f, UiHoveredBlue);
+								v2 startPos = Add(Add(TreeViewAt(nodePositions, branch->fromHandle.index), viewportOffset), viewportRec.TopLeft);
+								v2 endPos = Add(Add(TreeViewAt(nodePositions, branch->toHandle.index), viewportOffset), viewportRec.TopLeft);
+								bool isOnPath = IsTreeBitSet(&app->pathBranchBits, bIndex);
+								bool isOnHoveredChain = IsTreeBranchOnChain(&app->hoveredChains, bIndex);
+								if (isOnPath) { DrawLine(startPos, endPos, 5.0f, MonokaiYellow); }
+								else if (isOnHoveredChain) { DrawLine(startPos, endPos, 4.0f, MonokaiOrange); }
+								else { DrawLine(startPos, endPos, 3.0f, UiHoveredBlue); }
 							}
 						}
 					}
@@ -377,18 +664,35 @@ EXPORT_FUNC(AppUpdate) APP_UPDATE_DEF(AppUpdate)
 					// +==============================+
 					// |      Render Tree Nodes       |
 					// +==============================+
-					VarArrayLoop(&app->tree.nodes, nIndex)
+					TreeIdView nodeIds = GetTreeNodeIdsView(&app->tree);
+					TreePositionView nodePositions = GetTreeNodePositionsView(&app->tree);
+					TreeColorView nodeColors = GetTreeNodeColorsView(&app->tree);
+					TreeNodeView nodes = GetTreeNodesView(&app->tree);
+					TreeBitsLoop(&app->tree.visibleNodeBits, nIndex)
 					{
-						VarArrayLoopGet(TreeNode, node, &app->tree.nodes, nIndex);
-						Str8 nodeIdStr = PrintInArenaStr(scratch, "Node%llu", (u64)node->id);
-						Str8 nodeNameIdStr = PrintInArenaStr(scratch, "Node%lluName", (u64)node->id);
-						bool isHovered = (app->hoveredNode == node);
-						bool isMoving = (app->isMovingNode && app->movingNodeId == node->id);
+						uxx* nodeId = &TreeViewAt(nodeIds, nIndex);
+						v2* nodePosition = &TreeViewAt(nodePositions, nIndex);
+						Color32* nodeColor = &TreeViewAt(nodeColors, nIndex);
+						TreeNode* node = &TreeViewAt(nodes, nIndex); //cold data, we only need the name here
+						Str8 nodeIdStr = PrintInArenaStr(scratch, "Node%llu", (u64)(*nodeId));
+						Str8 nodeNameIdStr = PrintInArenaStr(scratch, "Node%lluName", (u64)(*nodeId));
+						bool isHovered = (app->hoveredNode.index == nIndex && !IsEmptyTreeNodeHandle(app->hoveredNode));
+						bool isMoving = (app->isMovingNode && app->movingNodeId == *nodeId);
+						TreeNodeHandle searchSelection = (app->selectedSearchResult < app->numSearchResults) ? app->searchResults[app->selectedSearchResult].node : TreeNodeHandle_Empty;
+						bool isSearchSelected = (app->isSearchFocused && searchSelection.index == nIndex && searchSelection.generation == node->generation);
+						bool isOnPath = (IsTreeBitSet(&app->pathNodeBits, nIndex) || (app->pathStartId != 0 && app->pathStartId == *nodeId));
+						bool isLearned = IsTreeNodeLearned(&app->tree, node);
+						bool isLocked = (!isLearned && !IsTreeNodeUnlocked(&app->tree, node));
+						Color32 fillColor = *nodeColor;
+						if (isLocked) { fillColor.a = (u8)(fillColor.a / 3); } //dependencies still need to be learned
 						
 						u16 borderWidth = 0;
 						Color32 borderColor = Transparent;
 						if (isMoving) { borderWidth = 1; borderColor = MonokaiYellow; }
 						else if (isHovered) { borderWidth = 2; borderColor = MonokaiLightBlue; }
+						else if (isSearchSelected) { borderWidth = 2; borderColor = MonokaiGreen; }
+						else if (isOnPath) { borderWidth = 2; borderColor = MonokaiYellow; }
+						else if (isLearned) { borderWidth = 2; borderColor = MonokaiDarkGreen; }
 						
 						CLAY({ .id = ToClayId(nodeIdStr),
 							.layout = {
@@ -397,11 +701,11 @@ EXPORT_FUNC(AppUpdate) APP_UPDATE_DEF(AppUpdate)
 							.floating = {
 								.attachTo = CLAY_ATTACH_TO_PARENT,
 								.zIndex = -2,
-								.offset = ToClayVector2(Add(node->position, viewportOffset)),
+								.offset = ToClayVector2(Add(*nodePosition, viewportOffset)),
 								.attachPoints = { .element = CLAY_ATTACH_POINT_CENTER_CENTER },
 							},
 							.cornerRadius = CLAY_CORNER_RADIUS(8),
-							.backgroundColor = ToClayColor(node->color),
+							.backgroundColor = ToClayColor(fillColor),
 							.border = { .width=CLAY_BORDER_OUTSIDE(borderWidth), .color=ToClayColor(borderColor) },
 						})
 						{
@@ -419,7 +723,7 @@ EXPORT_FUNC(AppUpdate) APP_UPDATE_DEF(AppUpdate)
 							})
 							{
 								CLAY_TEXT(
-									ToClayString(node->name),
+									ToClayString(GetTreeNodeName(&app->tree, node)),
 									CLAY_TEXT_CONFIG({
 										.fontId = app->clayUiFontId,
 										.fontSize = UI_FONT_SIZE,
@@ -432,6 +736,133 @@ EXPORT_FUNC(AppUpdate) APP_UPDATE_DEF(AppUpdate)
 						}
 					}
 					
+					// +==============================+
+					// |      Render Stats Panel      |
+					// +==============================+
+					if (app->isStatsPanelOpen)
+					{
+						TreeStats stats;
+						GetTreeStats(&app->tree, &stats);
+						VarArray statLines;
+						InitVarArray(Str8, &statLines, scratch);
+						*VarArrayAdd(Str8, &statLines) = PrintInArenaStr(scratch, "%llu nodes, %llu branches", (u64)stats.numNodes, (u64)stats.numBranches);
+						for (uxx tIndex = 1; tIndex < TreeNodeType_Count; tIndex++)
+						{
+							*VarArrayAdd(Str8, &statLines) = PrintInArenaStr(scratch, "  %s: %llu", GetTreeNodeTypeStr((TreeNodeType)tIndex), (u64)stats.numNodesByType[tIndex]);
+						}
+						for (uxx tIndex = 1; tIndex < TreeBranchType_Count; tIndex++)
+						{
+							*VarArrayAdd(Str8, &statLines) = PrintInArenaStr(scratch, "  %s: %llu", GetTreeBranchTypeStr((TreeBranchType)tIndex), (u64)stats.numBranchesByType[tIndex]);
+						}
+						*VarArrayAdd(Str8, &statLines) = PrintInArenaStr(scratch, "Orphan nodes: %llu", (u64)stats.numOrphanNodes);
+						*VarArrayAdd(Str8, &statLines) = PrintInArenaStr(scratch, "Dangling branch ends: %llu", (u64)stats.numDanglingBranchEnds);
+						*VarArrayAdd(Str8, &statLines) = PrintInArenaStr(scratch, "Longest chain: %llu", (u64)stats.longestChain);
+						if (stats.numCyclicNodes > 0) { *VarArrayAdd(Str8, &statLines) = PrintInArenaStr(scratch, "Nodes in or after cycles: %llu", (u64)stats.numCyclicNodes); }
+						*VarArrayAdd(Str8, &statLines) = PrintInArenaStr(scratch, "Components: %llu", (u64)stats.numComponents);
+						*VarArrayAdd(Str8, &statLines) = PrintInArenaStr(scratch, "Communities: %llu", (u64)app->communities.stats.numCommunities);
+						*VarArrayAdd(Str8, &statLines) = PrintInArenaStr(scratch, "Learned: %llu, unlocked: %llu", (u64)stats.numLearnedNodes, (u64)stats.numUnlockedNodes);
+						TreeNode* hoveredStatsNode = GetTreeNodeByHandle(&app->tree, app->hoveredNode);
+						if (hoveredStatsNode != nullptr)
+						{
+							TreeProgress componentProgress = GetTreeComponentProgress(&app->tree, hoveredStatsNode);
+							*VarArrayAdd(Str8, &statLines) = PrintInArenaStr(scratch, "  Hovered component: %llu/%llu", (u64)componentProgress.numLearned, (u64)componentProgress.numNodes);
+						}
+						if (stats.degreeCounts != nullptr)
+						{
+							*VarArrayAdd(Str8, &statLines) = StrLit("Degrees:");
+							uxx numOverflow = 0;
+							for (uxx dIndex = 0; dIndex <= stats.maxDegree; dIndex++)
+							{
+								if (dIndex >= STATS_PANEL_MAX_DEGREES) { numOverflow += stats.degreeCounts[dIndex]; }
+								else if (stats.degreeCounts[dIndex] > 0) { *VarArrayAdd(Str8, &statLines) = PrintInArenaStr(scratch, "  %llu: %llu", (u64)dIndex, (u64)stats.degreeCounts[dIndex]); }
+							}
+							if (numOverflow > 0) { *VarArrayAdd(Str8, &statLines) = PrintInArenaStr(scratch, "  %llu+: %llu", (u64)STATS_PANEL_MAX_DEGREES, (u64)numOverflow); }
+						}
+						
+						CLAY({ .id = CLAY_ID("StatsPanel"),
+							.floating = {
+								.attachTo = CLAY_ATTACH_TO_PARENT,
+								.zIndex = 4,
+								.offset = { -8, 8 },
+								.attachPoints = { .parent = CLAY_ATTACH_POINT_RIGHT_TOP, .element = CLAY_ATTACH_POINT_RIGHT_TOP },
+							},
+							.layout = {
+								.layoutDirection = CLAY_TOP_TO_BOTTOM,
+								.sizing = { .width = CLAY_SIZING_FIXED(STATS_PANEL_WIDTH) },
+								.padding = { 6, 6, 4, 4 },
+								.childGap = 2,
+							},
+							.backgroundColor = ToClayColor(UiBackgroundDarkGray),
+							.cornerRadius = CLAY_CORNER_RADIUS(4),
+							.border = { .width=CLAY_BORDER_OUTSIDE(1), .color=ToClayColor(UiOutlineGray) },
+						})
+						{
+							VarArrayLoop(&statLines, lIndex)
+							{
+								VarArrayLoopGet(Str8, statLine, &statLines, lIndex);
+								CLAY_TEXT(
+									ToClayString(*statLine),
+									CLAY_TEXT_CONFIG({
+										.fontId = app->clayUiFontId,
+										.fontSize = (u16)UI_FONT_SIZE,
+										.textColor = ToClayColor(UiTextWhite),
+										.wrapMode = CLAY_TEXT_WRAP_NONE,
+									})
+								);
+							}
+						}
+					}
+					
+					// +==============================+
+					// |   Render Similar Projects    |
+					// +==============================+
+					TreeNode* similarNode = GetTreeNodeByHandle(&app->tree, app->similarNode);
+					if (similarNode != nullptr && app->numSimilarResults > 0)
+					{
+						VarArray similarLines;
+						InitVarArray(Str8, &similarLines, scratch);
+						*VarArrayAdd(Str8, &similarLines) = PrintInArenaStr(scratch, "Similar to %.*s:", StrPrint(GetTreeNodeName(&app->tree, similarNode)));
+						for (uxx rIndex = 0; rIndex < app->numSimilarResults; rIndex++)
+						{
+							TreeNode* similarProject = GetTreeNodeByHandle(&app->tree, app->similarResults[rIndex].node);
+							if (similarProject == nullptr) { continue; }
+							*VarArrayAdd(Str8, &similarLines) = PrintInArenaStr(scratch, "  %.*s (%d%%)", StrPrint(GetTreeNodeName(&app->tree, similarProject)), (int)(app->similarResults[rIndex].similarity * 100.0f + 0.5f));
+						}
+						
+						CLAY({ .id = CLAY_ID("SimilarPanel"),
+							.floating = {
+								.attachTo = CLAY_ATTACH_TO_PARENT,
+								.zIndex = 4,
+								.offset = { 8, 8 },
+								.attachPoints = { .parent = CLAY_ATTACH_POINT_LEFT_TOP, .element = CLAY_ATTACH_POINT_LEFT_TOP },
+							},
+							.layout = {
+								.layoutDirection = CLAY_TOP_TO_BOTTOM,
+								.sizing = { .width = CLAY_SIZING_FIXED(SIMILAR_PANEL_WIDTH) },
+								.padding = { 6, 6, 4, 4 },
+								.childGap = 2,
+							},
+							.backgroundColor = ToClayColor(UiBackgroundDarkGray),
+							.cornerRadius = CLAY_CORNER_RADIUS(4),
+							.border = { .width=CLAY_BORDER_OUTSIDE(1), .color=ToClayColor(UiOutlineGray) },
+						})
+						{
+							VarArrayLoop(&similarLines, lIndex)
+							{
+								VarArrayLoopGet(Str8, similarLine, &similarLines, lIndex);
+								CLAY_TEXT(
+									ToClayString(*similarLine),
+									CLAY_TEXT_CONFIG({
+										.fontId = app->clayUiFontId,
+										.fontSize = (u16)UI_FONT_SIZE,
+										.textColor = ToClayColor(UiTextWhite),
+										.wrapMode = CLAY_TEXT_WRAP_NONE,
+									})
+								);
+							}
+						}
+					}
+					
 					#if DEBUG_BUILD
 					CLAY({.id = CLAY_ID("Graph Bounds"),
 						.layout = {
@@ -470,6 +901,8 @@ EXPORT_FUNC(AppClosing) APP_CLOSING_DEF(AppClosing)
 	ScratchBegin2(scratch3, scratch, scratch2);
 	UpdateDllGlobals(inPlatformInfo, inPlatformApi, memoryPntr, nullptr);
 	
+	CancelTreeCommunityJob(&app->communities); //the worker's code lives in this dll
+	
 	#if BUILD_WITH_IMGUI
 	igSaveIniSettingsToDisk(app->imgui->io->IniFilename);
 	#endif
@@ -21,18 +21,53 @@ struct AppData
 	
 	bool isFileMenuOpen;
 	bool keepFileMenuOpenUntilMouseOver;
+	bool isViewMenuOpen;
+	bool keepViewMenuOpenUntilMouseOver;
+	bool isStatsPanelOpen;
+	
+	bool isSearchFocused;
+	uxx searchLength;
+	char searchBuffer[NODE_SEARCH_MAX_LENGTH];
+	uxx numSearchResults;
+	TreeSearchResult searchResults[NODE_SEARCH_MAX_RESULTS];
+	uxx selectedSearchResult;
 	
 	SkillTree tree;
+	TreeUndoJournal undo;
+	TreeReachIndex dependencyReach; //every node's prerequisites and dependents, rebuilt the first time it's asked after a Dependency edit
+	TreeSnapshotPublisher snapshots; //published at the end of every AppUpdate that changed the tree
+	TreeCommunities communities; //colors the nodes by community, found on a worker thread from the snapshots
 	
 	v2 viewPosition; //center of view
 	bool isMovingView;
 	v2 movingViewGrabPos;
 	rec graphBounds;
 	
-	TreeNode* hoveredNode;
+	TreeNodeHandle hoveredNode;
+	TreeChainCache hoveredChains; //the hovered node's upstream and downstream Dependency chains, highlighted in the branch loop
 	bool isMovingNode;
 	v2 movingNodeGrabOffset;
 	uxx movingNodeId;
+	v2 movingNodeStartPos;
+	
+	// Right click a node to start a learning path and another node to end it, right click the background to clear it.
+	// The path is found again whenever the tree changes (moving a node changes the costs too)
+	uxx pathStartId;
+	uxx pathEndId;
+	bool pathDirty;
+	u64 pathTreeVersion; //SkillTree::snapshotVersion when we last ran FindTreePath
+	bool pathFound;
+	VarArray pathNodes; //TreeNodeHandle
+	VarArray pathBranches; //TreeBranchHandle
+	VarArray pathNodeBits; //u64 (by node index, so rendering only has to test a bit)
+	VarArray pathBranchBits; //u64 (by branch index)
+	
+	// Hovering a Project lists the projects whose dependencies are most like its own, found again when the hover or any references change
+	TreeSimilarIndex similarProjects;
+	TreeNodeHandle similarNode;
+	u64 similarRefsVersion; //SkillTree::refsVersion when we last ran FindSimilarTreeNodes
+	uxx numSimilarResults;
+	TreeSimilarMatch similarResults[SIMILAR_PANEL_MAX_RESULTS];
 };
 
 #endif //  _APP_MAIN_H
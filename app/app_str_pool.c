@@ -0,0 +1,136 @@
+/*
+File:   app_str_pool.c
+Author: Taylor Robbins
+Date:   10\16\2026
+Description: 
+	** Holds the API for StrPool, a table of interned strings that the SkillTree uses to store node and branch names
+*/
+
+void FreeStrPool(StrPool* pool)
+{
+	NotNull(pool);
+	if (pool->arena != nullptr)
+	{
+		FreeVarArray(&pool->chars);
+		FreeVarArray(&pool->entries);
+		if (pool->lookup != nullptr) { FreeArray(u32, pool->arena, pool->lookupCapacity, pool->lookup); }
+	}
+	ClearPointer(pool);
+}
+
+void InitStrPool(Arena* arena, StrPool* poolOut)
+{
+	NotNull(arena);
+	NotNull(poolOut);
+	ClearPointer(poolOut);
+	poolOut->arena = arena;
+	InitVarArray(char, &poolOut->chars, arena);
+	InitVarArray(StrPoolEntry, &poolOut->entries, arena);
+	StrPoolEntry* emptyEntry = VarArrayAdd(StrPoolEntry, &poolOut->entries);
+	NotNull(emptyEntry);
+	ClearPointer(emptyEntry);
+}
+
+// FNV-1a
+u64 HashStrPoolStr(Str8 str)
+{
+	u64 result = 14695981039346656037ULL;
+	for (uxx cIndex = 0; cIndex < str.length; cIndex++)
+	{
+		result ^= (u64)(u8)str.chars[cIndex];
+		result *= 1099511628211ULL;
+	}
+	return result;
+}
+
+uxx GetNumStrPoolStrs(StrPool* pool)
+{
+	return pool->entries.length - 1;
+}
+
+Str8 GetStrPoolStr(StrPool* pool, u32 strId)
+{
+	NotNull(pool);
+	if (strId == STR_POOL_EMPTY_ID) { return Str8_Empty; }
+	StrPoolEntry* entry = VarArrayGetHard(StrPoolEntry, &pool->entries, strId);
+	return NewStr8(entry->length, (char*)pool->chars.items + entry->offset);
+}
+
+// The hash only depends on the contents of the string so it can be compared across pools. The empty string hashes to 0
+u64 GetStrPoolStrHash(StrPool* pool, u32 strId)
+{
+	NotNull(pool);
+	if (strId == STR_POOL_EMPTY_ID) { return 0; }
+	return VarArrayGetHard(StrPoolEntry, &pool->entries, strId)->hash;
+}
+
+void StrPoolGrowLookup(StrPool* pool)
+{
+	uxx newCapacity = (pool->lookupCapacity > 0) ? pool->lookupCapacity * 2 : STR_POOL_MIN_CAPACITY;
+	u32* newLookup = AllocArray(u32, pool->arena, newCapacity);
+	NotNull(newLookup);
+	MyMemSet(newLookup, 0x00, sizeof(u32) * newCapacity);
+	for (uxx eIndex = 1; eIndex < pool->entries.length; eIndex++)
+	{
+		StrPoolEntry* entry = VarArrayGetHard(StrPoolEntry, &pool->entries, eIndex);
+		uxx slotIndex = (uxx)(entry->hash & (newCapacity - 1));
+		while (newLookup[slotIndex] != 0) { slotIndex = ((slotIndex + 1) & (newCapacity - 1)); }
+		newLookup[slotIndex] = (u32)eIndex;
+	}
+	if (pool->lookup != nullptr) { FreeArray(u32, pool->arena, pool->lookupCapacity, pool->lookup); }
+	pool->lookup = newLookup;
+	pool->lookupCapacity = newCapacity;
+}
+
+// Returns STR_POOL_EMPTY_ID if the string is empty or is not in the pool
+u32 FindStrPoolId(StrPool* pool, Str8 str)
+{
+	NotNull(pool);
+	if (str.length == 0 || pool->lookupCapacity == 0) { return STR_POOL_EMPTY_ID; }
+	u64 hash = HashStrPoolStr(str);
+	uxx slotIndex = (uxx)(hash & (pool->lookupCapacity - 1));
+	while (pool->lookup[slotIndex] != 0)
+	{
+		u32 strId = pool->lookup[slotIndex];
+		StrPoolEntry* entry = VarArrayGetHard(StrPoolEntry, &pool->entries, strId);
+		if (entry->hash == hash && entry->length == str.length &&
+			MyMemCompare((char*)pool->chars.items + entry->offset, str.chars, str.length) == 0)
+		{
+			return strId;
+		}
+		slotIndex = ((slotIndex + 1) & (pool->lookupCapacity - 1));
+	}
+	return STR_POOL_EMPTY_ID;
+}
+
+u32 InternStr(StrPool* pool, Str8 str)
+{
+	NotNull(pool);
+	NotNull(pool->arena);
+	if (str.length == 0) { return STR_POOL_EMPTY_ID; }
+	u32 existingId = FindStrPoolId(pool, str);
+	if (existingId != STR_POOL_EMPTY_ID) { return existingId; }
+	
+	// Keep the lookup at most half full
+	if ((pool->entries.length + 1) * 2 > pool->lookupCapacity) { StrPoolGrowLookup(pool); }
+	Assert(pool->chars.length + str.length <= UINT32_MAX && pool->entries.length < UINT32_MAX);
+	
+	u32 newId = (u32)pool->entries.length;
+	StrPoolEntry* newEntry = VarArrayAdd(StrPoolEntry, &pool->entries);
+	NotNull(newEntry);
+	newEntry->hash = HashStrPoolStr(str);
+	newEntry->offset = (u32)pool->chars.length;
+	newEntry->length = (u32)str.length;
+	// The caller may have handed us a slice of a string that's already in the pool, which would move when chars grows
+	bool isInsidePool = (pool->chars.length > 0 && str.chars >= (char*)pool->chars.items && str.chars < (char*)pool->chars.items + pool->chars.length);
+	uxx insideOffset = isInsidePool ? (uxx)(str.chars - (char*)pool->chars.items) : 0;
+	char* newChars = VarArrayAddMulti(char, &pool->chars, str.length);
+	NotNull(newChars);
+	if (isInsidePool) { str.chars = (char*)pool->chars.items + insideOffset; }
+	MyMemCopy(newChars, str.chars, str.length);
+	
+	uxx slotIndex = (uxx)(newEntry->hash & (pool->lookupCapacity - 1));
+	while (pool->lookup[slotIndex] != 0) { slotIndex = ((slotIndex + 1) & (pool->lookupCapacity - 1)); }
+	pool->lookup[slotIndex] = newId;
+	return newId;
+}
@@ -0,0 +1,35 @@
+/*
+File:   app_str_pool.h
+Author: Taylor Robbins
+Date:   10\16\2026
+*/
+
+#ifndef _APP_STR_POOL_H
+#define _APP_STR_POOL_H
+
+// Id 0 is always the empty string and takes no space in the pool
+#define STR_POOL_EMPTY_ID      0
+#define STR_POOL_MIN_CAPACITY  16
+
+typedef struct StrPoolEntry StrPoolEntry;
+struct StrPoolEntry
+{
+	u64 hash;
+	u32 offset; //into StrPool::chars
+	u32 length;
+};
+
+// Interns strings into one contiguous blob of chars. Each unique string is only stored once and is referred to by a u32 id.
+// Strings are never removed from the pool, so the memory used is bounded by the number of unique strings, not the number of references to them.
+// NOTE: The Str8 returned by GetStrPoolStr points into the blob and is only valid until the next InternStr call
+typedef struct StrPool StrPool;
+struct StrPool
+{
+	Arena* arena;
+	VarArray chars; //char
+	VarArray entries; //StrPoolEntry (index 0 is unused since that's STR_POOL_EMPTY_ID)
+	uxx lookupCapacity; //power of 2
+	u32* lookup; //entry ids (0 means empty slot), probed linearly from hash
+};
+
+#endif //  _APP_STR_POOL_H
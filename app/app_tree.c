@@ -6,220 +6,1673 @@ Description:
 	** Holds the API for the SkillTree structure which contains some number of TreeNodes and TreeBranches
 */
 
+// When the references array has more than this many unused slots (and more unused than used) we compact it
+#define TREE_REFS_COMPACT_MIN_UNUSED  1024
+#define TREE_REFS_MIN_CAPACITY        4
+// If an edit transaction is expected to touch more than 1/TREE_EDIT_REBAKE_DIVISOR of the tree
+// we drop the references for the duration of the edit and rebake once on commit
+#define TREE_EDIT_REBAKE_DIVISOR      8
+
+// +--------------------------------------------------------------+
+// |                         Typed Views                          |
+// +--------------------------------------------------------------+
+#if DEBUG_BUILD
+void* CheckTreeViewArray(const VarArray* array, uxx itemSize)
+{
+	NotNull(array);
+	Assert(array->itemSize == itemSize);
+	return array->items;
+}
+uxx CheckTreeViewIndex(uxx index, uxx count)
+{
+	Assert(index < count);
+	return index;
+}
+#endif
+
+TreeNodeView GetTreeNodesView(SkillTree* tree) { return NewTreeView(TreeNodeView, TreeNode, &tree->nodes); }
+TreeIdView GetTreeNodeIdsView(SkillTree* tree) { return NewTreeView(TreeIdView, uxx, &tree->nodeIds); }
+TreePositionView GetTreeNodePositionsView(SkillTree* tree) { return NewTreeView(TreePositionView, v2, &tree->nodePositions); }
+TreeColorView GetTreeNodeColorsView(SkillTree* tree) { return NewTreeView(TreeColorView, Color32, &tree->nodeColors); }
+TreeBranchView GetTreeBranchesView(SkillTree* tree) { return NewTreeView(TreeBranchView, TreeBranch, &tree->branches); }
+TreeNodeRefsView GetTreeNodeRefsView(SkillTree* tree) { return NewTreeView(TreeNodeRefsView, TreeNodeRefs, &tree->nodeRefs); }
+TreeReferenceView GetTreeReferencesView(SkillTree* tree) { return NewTreeView(TreeReferenceView, TreeReference, &tree->references); }
+TreeU32View GetTreeNodeTiersView(SkillTree* tree) { return NewTreeView(TreeU32View, u32, &tree->nodeTiers); }
+
+// NOTE: The generation survives FreeTreeNode/FreeTreeBranch because it belongs to the slot, not the node
 void FreeTreeNode(SkillTree* tree, TreeNode* node)
 {
 	NotNull(tree);
 	NotNull(tree->arena);
 	NotNull(node);
-	FreeStr8(tree->arena, &node->name);
+	u32 generation = node->generation;
 	ClearPointer(node);
+	node->generation = generation;
+}
+
+void FreeTreeBranch(SkillTree* tree, TreeBranch* branch)
+{
+	NotNull(tree);
+	NotNull(tree->arena);
+	NotNull(branch);
+	u32 generation = branch->generation;
+	ClearPointer(branch);
+	branch->generation = generation;
+}
+
+void FreeSkillTree(SkillTree* tree)
+{
+	NotNull(tree);
+	if (tree->arena != nullptr)
+	{
+		// Nothing in the tree points outside of its arena so there's no need to free the nodes, branches or arrays one by one
+		OsFreeReservedMemory(tree->arena->mainPntr, tree->arena->size);
+		FreeType(Arena, tree->sourceArena, tree->arena);
+	}
+	ClearPointer(tree);
+}
+
+// The arena is only used to allocate the Arena struct for the tree's own arena, everything else goes in there
+void InitSkillTree(Arena* arena, SkillTree* treeOut)
+{
+	NotNull(arena);
+	NotNull(treeOut);
+	ClearPointer(treeOut);
+	treeOut->sourceArena = arena;
+	treeOut->arena = AllocType(Arena, arena);
+	NotNull(treeOut->arena);
+	InitArenaStackVirtual(treeOut->arena, TREE_ARENA_MAX_SIZE);
+	treeOut->nextNodeId = 1;
+	treeOut->referencesBaked = false;
+	treeOut->rejectDependencyCycles = true;
+	InitStrPool(treeOut->arena, &treeOut->names);
+	InitTrigramIndex(treeOut->arena, &treeOut->nameIndex);
+	InitVarArray(u32, &treeOut->freeNodeSlots, treeOut->arena);
+	InitVarArray(TreeNode, &treeOut->nodes, treeOut->arena);
+	InitVarArray(uxx, &treeOut->nodeIds, treeOut->arena);
+	InitVarArray(v2, &treeOut->nodePositions, treeOut->arena);
+	InitVarArray(Color32, &treeOut->nodeColors, treeOut->arena);
+	InitIdTable(treeOut->arena, &treeOut->nodeLookup);
+	InitIdTable(treeOut->arena, &treeOut->danglingEndLookup);
+	InitVarArray(TreeDanglingEnd, &treeOut->danglingEnds, treeOut->arena);
+	InitVarArray(u32, &treeOut->freeBranchSlots, treeOut->arena);
+	InitVarArray(TreeBranch, &treeOut->branches, treeOut->arena);
+	for (uxx tIndex = 0; tIndex < TreeNodeType_Count; tIndex++) { InitVarArray(u64, &treeOut->nodeTypeBits[tIndex], treeOut->arena); }
+	for (uxx tIndex = 0; tIndex < TreeBranchType_Count; tIndex++) { InitVarArray(u64, &treeOut->branchTypeBits[tIndex], treeOut->arena); }
+	treeOut->visibleNodeTypes = TreeNodeTypeFlags_All;
+	treeOut->visibleBranchTypes = TreeBranchTypeFlags_All;
+	InitVarArray(u64, &treeOut->visibleNodeBits, treeOut->arena);
+	InitVarArray(u64, &treeOut->visibleBranchBits, treeOut->arena);
+	InitVarArray(u64, &treeOut->nodeLearnedBits, treeOut->arena);
+	InitVarArray(uxx, &treeOut->pendingNodeRemovals, treeOut->arena);
+	InitVarArray(u64, &treeOut->nodePageVersions, treeOut->arena);
+	InitVarArray(u64, &treeOut->branchPageVersions, treeOut->arena);
+	InitVarArray(u64, &treeOut->nodeRefPageVersions, treeOut->arena);
+	InitVarArray(TreeHashEntry, &treeOut->nodeHashEntries, treeOut->arena);
+	InitVarArray(TreeHashEntry, &treeOut->branchHashEntries, treeOut->arena);
+	// The baked arrays are only filled while referencesBaked, but they keep their buffers across unbaking so baking again doesn't allocate them over
+	InitVarArray(TreeNodeRefs, &treeOut->nodeRefs, treeOut->arena);
+	InitVarArray(TreeReference, &treeOut->references, treeOut->arena);
+	InitVarArray(u32, &treeOut->nodeTiers, treeOut->arena);
+	InitVarArray(u32, &treeOut->topoOrder, treeOut->arena);
+	InitVarArray(u32, &treeOut->cycleSearchMarks, treeOut->arena);
+	InitVarArray(uxx, &treeOut->degreeCounts, treeOut->arena);
+	InitVarArray(uxx, &treeOut->tierCounts, treeOut->arena);
+	InitVarArray(u32, &treeOut->componentParents, treeOut->arena);
+	InitVarArray(u8, &treeOut->componentRanks, treeOut->arena);
+	InitVarArray(TreeProgress, &treeOut->componentProgress, treeOut->arena);
+	InitVarArray(u32, &treeOut->nodeUnmetDependencies, treeOut->arena);
+	MyMemSet(&treeOut->nodeHashHeads[0], 0xFF, sizeof(treeOut->nodeHashHeads)); //TREE_INVALID_INDEX
+	MyMemSet(&treeOut->branchHashHeads[0], 0xFF, sizeof(treeOut->branchHashHeads));
+	treeOut->rootHashDirty = true;
+}
+
+// Includes the old buffers left behind when arrays grew. Those aren't reused, but they're bounded by the size the arrays grew to
+// (rebaking and compacting don't allocate new ones) and they're all given back by FreeSkillTree
+uxx GetSkillTreeBytesUsed(const SkillTree* tree)
+{
+	NotNull(tree);
+	return (tree->arena != nullptr) ? tree->arena->used : 0;
+}
+
+// +--------------------------------------------------------------+
+// |                       Change Tracking                        |
+// +--------------------------------------------------------------+
+void StampTreeSnapshotPage(SkillTree* tree, VarArray* pageVersions, uxx slotIndex)
+{
+	uxx pageIndex = slotIndex / TREE_SNAPSHOT_PAGE_SIZE;
+	while (pageVersions->length <= pageIndex) { *VarArrayAdd(u64, pageVersions) = 0; }
+	tree->snapshotVersion++;
+	*VarArrayGetHard(u64, pageVersions, pageIndex) = tree->snapshotVersion;
+}
+void StampTreeNodeRefsPage(SkillTree* tree, uxx nodeIndex)
+{
+	uxx pageIndex = nodeIndex / TREE_SNAPSHOT_PAGE_SIZE;
+	while (tree->nodeRefPageVersions.length <= pageIndex) { *VarArrayAdd(u64, &tree->nodeRefPageVersions) = 0; }
+	tree->refsVersion++;
+	*VarArrayGetHard(u64, &tree->nodeRefPageVersions, pageIndex) = tree->refsVersion;
+}
+void StampAllTreeNodeRefsPages(SkillTree* tree)
+{
+	for (uxx nIndex = 0; nIndex < tree->nodes.length; nIndex += TREE_SNAPSHOT_PAGE_SIZE) { StampTreeNodeRefsPage(tree, nIndex); }
+}
+u64 GetTreeStructureVersion(const SkillTree* tree)
+{
+	NotNull(tree);
+	return tree->nodesVersion + tree->refsVersion;
+}
+
+u64 HashTreeBytes(const void* bytesPntr, uxx numBytes)
+{
+	meow_u128 hash = MeowHash(MeowDefaultSeed, (meow_umm)numBytes, (void*)bytesPntr);
+	return (u64)MeowU64From(hash, 0);
+}
+uxx GetTreeHashBucket(u64 key)
+{
+	return (uxx)((key * 11400714819323198485ULL) >> (64 - TREE_HASH_BUCKET_BITS));
+}
+u64 GetTreeBranchHashKey(const TreeBranch* branch)
+{
+	u64 keyInput[3] = { (u64)branch->fromId, (u64)branch->toId, (u64)branch->type };
+	return HashTreeBytes(&keyInput[0], sizeof(keyInput));
+}
+// Positions are hashed by their bits, so a node that moves and then moves back to exactly where it was hashes the same again
+u64 CalculateTreeNodeHash(SkillTree* tree, uxx nodeIndex)
+{
+	TreeNode* node = VarArrayGetHard(TreeNode, &tree->nodes, nodeIndex);
+	v2 position = *VarArrayGetHard(v2, &tree->nodePositions, nodeIndex);
+	Color32 color = *VarArrayGetHard(Color32, &tree->nodeColors, nodeIndex);
+	u32 positionBits[2];
+	MyMemCopy(&positionBits[0], &position.X, sizeof(u32));
+	MyMemCopy(&positionBits[1], &position.Y, sizeof(u32));
+	u64 hashInput[6] = { TREE_HASH_NODE_TAG, (u64)node->id, (u64)node->type, GetStrPoolStrHash(&tree->names, node->nameId), ((u64)positionBits[0] << 32) | (u64)positionBits[1], (u64)color.valueU32 };
+	return HashTreeBytes(&hashInput[0], sizeof(hashInput));
+}
+u64 CalculateTreeBranchHash(SkillTree* tree, uxx branchIndex)
+{
+	TreeBranch* branch = VarArrayGetHard(TreeBranch, &tree->branches, branchIndex);
+	u64 hashInput[5] = { TREE_HASH_BRANCH_TAG, (u64)branch->fromId, (u64)branch->toId, (u64)branch->type, GetStrPoolStrHash(&tree->names, branch->nameId) };
+	return HashTreeBytes(&hashInput[0], sizeof(hashInput));
+}
+
+void UnlinkTreeHashEntry(SkillTree* tree, VarArray* entries, u32* bucketHeads, uxx index)
+{
+	TreeHashEntry* entry = VarArrayGetHard(TreeHashEntry, entries, index);
+	if (entry->bucket == TREE_INVALID_INDEX) { return; }
+	tree->bucketHashes[entry->bucket] -= entry->hash;
+	if (entry->prev != TREE_INVALID_INDEX) { VarArrayGetHard(TreeHashEntry, entries, entry->prev)->next = entry->next; }
+	else { bucketHeads[entry->bucket] = entry->next; }
+	if (entry->next != TREE_INVALID_INDEX) { VarArrayGetHard(TreeHashEntry, entries, entry->next)->prev = entry->prev; }
+	entry->hash = 0;
+	entry->bucket = TREE_INVALID_INDEX;
+	entry->prev = TREE_INVALID_INDEX;
+	entry->next = TREE_INVALID_INDEX;
+	tree->rootHashDirty = true;
+}
+void LinkTreeHashEntry(SkillTree* tree, VarArray* entries, u32* bucketHeads, uxx index, uxx bucket, u64 hash)
+{
+	TreeHashEntry* entry = VarArrayGetHard(TreeHashEntry, entries, index);
+	Assert(entry->bucket == TREE_INVALID_INDEX);
+	entry->hash = hash;
+	entry->bucket = (u32)bucket;
+	entry->prev = TREE_INVALID_INDEX;
+	entry->next = bucketHeads[bucket];
+	if (entry->next != TREE_INVALID_INDEX) { VarArrayGetHard(TreeHashEntry, entries, entry->next)->prev = (u32)index; }
+	bucketHeads[bucket] = (u32)index;
+	tree->bucketHashes[bucket] += hash;
+	tree->rootHashDirty = true;
+}
+TreeHashEntry* GetTreeHashEntry(VarArray* entries, uxx index)
+{
+	while (entries->length <= index)
+	{
+		TreeHashEntry* newEntry = VarArrayAdd(TreeHashEntry, entries);
+		newEntry->hash = 0;
+		newEntry->bucket = TREE_INVALID_INDEX;
+		newEntry->prev = TREE_INVALID_INDEX;
+		newEntry->next = TREE_INVALID_INDEX;
+	}
+	return VarArrayGetHard(TreeHashEntry, entries, index);
+}
+
+// Every function that changes what a node or branch looks like (including adding/removing it) calls one of these afterwards.
+// They stamp the snapshot page the element lives in and re-hash it into its bucket
+void MarkTreeNodeChanged(SkillTree* tree, uxx nodeIndex)
+{
+	NotNull(tree);
+	StampTreeSnapshotPage(tree, &tree->nodePageVersions, nodeIndex);
+	GetTreeHashEntry(&tree->nodeHashEntries, nodeIndex);
+	UnlinkTreeHashEntry(tree, &tree->nodeHashEntries, &tree->nodeHashHeads[0], nodeIndex);
+	TreeNode* node = VarArrayGetHard(TreeNode, &tree->nodes, nodeIndex);
+	if (IsTreeSlotGenerationAlive(node->generation))
+	{
+		LinkTreeHashEntry(tree, &tree->nodeHashEntries, &tree->nodeHashHeads[0], nodeIndex, GetTreeHashBucket((u64)node->id), CalculateTreeNodeHash(tree, nodeIndex));
+	}
+}
+void MarkTreeBranchChanged(SkillTree* tree, uxx branchIndex)
+{
+	NotNull(tree);
+	StampTreeSnapshotPage(tree, &tree->branchPageVersions, branchIndex);
+	GetTreeHashEntry(&tree->branchHashEntries, branchIndex);
+	UnlinkTreeHashEntry(tree, &tree->branchHashEntries, &tree->branchHashHeads[0], branchIndex);
+	TreeBranch* branch = VarArrayGetHard(TreeBranch, &tree->branches, branchIndex);
+	if (IsTreeSlotGenerationAlive(branch->generation))
+	{
+		LinkTreeHashEntry(tree, &tree->branchHashEntries, &tree->branchHashHeads[0], branchIndex, GetTreeHashBucket(GetTreeBranchHashKey(branch)), CalculateTreeBranchHash(tree, branchIndex));
+	}
+}
+// Used by baking/unbaking which touch the handles in every branch. Handles aren't part of the content so nothing is re-hashed
+void MarkAllTreeBranchesChanged(SkillTree* tree)
+{
+	NotNull(tree);
+	for (uxx bIndex = 0; bIndex < tree->branches.length; bIndex += TREE_SNAPSHOT_PAGE_SIZE) { StampTreeSnapshotPage(tree, &tree->branchPageVersions, bIndex); }
+}
+
+// Two trees with the same nodes (ids, types, names, positions, colors) and branches have the same root hash, no matter
+// which slots they ended up in. Only re-hashes the bucket hashes (not the elements) and only when something changed
+u64 GetTreeRootHash(SkillTree* tree)
+{
+	NotNull(tree);
+	if (tree->rootHashDirty)
+	{
+		tree->rootHash = HashTreeBytes(&tree->bucketHashes[0], sizeof(tree->bucketHashes));
+		tree->rootHashDirty = false;
+	}
+	return tree->rootHash;
+}
+
+TreeNode* GetTreeNodeById(SkillTree* tree, uxx nodeId)
+{
+	NotNull(tree);
+	if (nodeId == 0) { return nullptr; }
+	uxx nodeIndex = 0;
+	if (!IdTableFind(&tree->nodeLookup, nodeId, &nodeIndex)) { return nullptr; }
+	TreeNodeView nodes = GetTreeNodesView(tree);
+	return &TreeViewAt(nodes, nodeIndex);
+}
+TreeBranch* GetTreeBranchById(SkillTree* tree, uxx nodeId, uxx index)
+{
+	uxx foundIndex = 0;
+	TreeBranchView branches = GetTreeBranchesView(tree);
+	for (uxx bIndex = 0; bIndex < branches.count; bIndex++)
+	{
+		TreeBranch* branch = &TreeViewAt(branches, bIndex);
+		if (!IsTreeSlotGenerationAlive(branch->generation)) { continue; }
+		if (branch->fromId == nodeId || branch->toId == nodeId)
+		{
+			if (foundIndex >= index) { return branch; }
+			foundIndex++;
+		}
+	}
+	return nullptr;
+}
+
+uxx GetTreeNodeIndex(SkillTree* tree, const TreeNode* node)
+{
+	NotNull(tree);
+	NotNull(node);
+	uxx nodeIndex = 0;
+	bool foundIndex = VarArrayGetIndexOf(TreeNode, &tree->nodes, node, &nodeIndex);
+	Assert(foundIndex);
+	return nodeIndex;
+}
+TreeNodeHandle GetTreeNodeHandle(SkillTree* tree, const TreeNode* node)
+{
+	if (node == nullptr) { return TreeNodeHandle_Empty; }
+	Assert(IsTreeSlotGenerationAlive(node->generation));
+	TreeNodeHandle result = ZEROED;
+	result.index = (u32)GetTreeNodeIndex(tree, node);
+	result.generation = node->generation;
+	return result;
+}
+TreeNode* GetTreeNodeByHandle(SkillTree* tree, TreeNodeHandle handle)
+{
+	NotNull(tree);
+	TreeNodeView nodes = GetTreeNodesView(tree);
+	if (IsEmptyTreeNodeHandle(handle) || handle.index >= nodes.count) { return nullptr; }
+	TreeNode* node = &TreeViewAt(nodes, handle.index);
+	return (node->generation == handle.generation) ? node : nullptr;
+}
+
+// NOTE: The returned Str8 points into tree->names and is only valid until the next name is added to the tree
+Str8 GetTreeNodeName(SkillTree* tree, const TreeNode* node)
+{
+	NotNull(tree);
+	NotNull(node);
+	return GetStrPoolStr(&tree->names, node->nameId);
+}
+void SetTreeNodeNameId(SkillTree* tree, TreeNode* node, u32 nameId)
+{
+	NotNull(tree);
+	NotNull(node);
+	Assert(nameId <= GetNumStrPoolStrs(&tree->names)); //id 0 (the empty string) isn't counted
+	if (node->nameId == nameId) { return; }
+	uxx nodeIndex = GetTreeNodeIndex(tree, node);
+	RemoveTrigramIndexItem(&tree->nameIndex, nodeIndex, GetStrPoolStr(&tree->names, node->nameId));
+	node->nameId = nameId;
+	AddTrigramIndexItem(&tree->nameIndex, nodeIndex, GetStrPoolStr(&tree->names, nameId));
+	MarkTreeNodeChanged(tree, nodeIndex);
+}
+void SetTreeNodeName(SkillTree* tree, TreeNode* node, Str8 name)
+{
+	NotNull(tree);
+	SetTreeNodeNameId(tree, node, InternStr(&tree->names, name));
+}
+
+v2 GetTreeNodePosition(SkillTree* tree, const TreeNode* node)
+{
+	return *VarArrayGetHard(v2, &tree->nodePositions, GetTreeNodeIndex(tree, node));
+}
+void SetTreeNodePosition(SkillTree* tree, const TreeNode* node, v2 position)
+{
+	uxx nodeIndex = GetTreeNodeIndex(tree, node);
+	*VarArrayGetHard(v2, &tree->nodePositions, nodeIndex) = position;
+	MarkTreeNodeChanged(tree, nodeIndex);
+}
+Color32 GetTreeNodeColor(SkillTree* tree, const TreeNode* node)
+{
+	return *VarArrayGetHard(Color32, &tree->nodeColors, GetTreeNodeIndex(tree, node));
+}
+void SetTreeNodeColor(SkillTree* tree, const TreeNode* node, Color32 color)
+{
+	uxx nodeIndex = GetTreeNodeIndex(tree, node);
+	*VarArrayGetHard(Color32, &tree->nodeColors, nodeIndex) = color;
+	MarkTreeNodeChanged(tree, nodeIndex);
+}
+
+uxx GetTreeBranchIndex(SkillTree* tree, const TreeBranch* branch)
+{
+	NotNull(tree);
+	NotNull(branch);
+	uxx branchIndex = 0;
+	bool foundIndex = VarArrayGetIndexOf(TreeBranch, &tree->branches, branch, &branchIndex);
+	Assert(foundIndex);
+	return branchIndex;
+}
+Str8 GetTreeBranchName(SkillTree* tree, const TreeBranch* branch)
+{
+	NotNull(tree);
+	NotNull(branch);
+	return GetStrPoolStr(&tree->names, branch->nameId);
+}
+
+TreeBranchHandle GetTreeBranchHandle(SkillTree* tree, const TreeBranch* branch)
+{
+	if (branch == nullptr) { return TreeBranchHandle_Empty; }
+	Assert(IsTreeSlotGenerationAlive(branch->generation));
+	TreeBranchHandle result = ZEROED;
+	result.index = (u32)GetTreeBranchIndex(tree, branch);
+	result.generation = branch->generation;
+	return result;
+}
+TreeBranch* GetTreeBranchByHandle(SkillTree* tree, TreeBranchHandle handle)
+{
+	NotNull(tree);
+	if (IsEmptyTreeBranchHandle(handle) || handle.index >= tree->branches.length) { return nullptr; }
+	TreeBranch* branch = VarArrayGetHard(TreeBranch, &tree->branches, handle.index);
+	return (branch->generation == handle.generation) ? branch : nullptr;
+}
+
+// +--------------------------------------------------------------+
+// |                      Visibility Bits                         |
+// +--------------------------------------------------------------+
+u8 CountTreeBitTrailingZeros(u64 word) //word can't be 0
+{
+	#if COMPILER_IS_MSVC
+	unsigned long result = 0;
+	_BitScanForward64(&result, word);
+	return (u8)result;
+	#else
+	return (u8)__builtin_ctzll(word);
+	#endif
+}
+
+bool IsTreeBitSet(const VarArray* bits, uxx index)
+{
+	if (index / 64 >= bits->length) { return false; }
+	return ((((const u64*)bits->items)[index / 64] >> (index % 64)) & 1) != 0;
+}
+void SetTreeBit(VarArray* bits, uxx index, bool value)
+{
+	while (bits->length <= index / 64)
+	{
+		if (!value) { return; }
+		*VarArrayAdd(u64, bits) = 0;
+	}
+	u64* word = VarArrayGetHard(u64, bits, index / 64);
+	if (value) { *word |= (1ULL << (index % 64)); }
+	else { *word &= ~(1ULL << (index % 64)); }
+}
+void ReserveTreeBits(VarArray* bits, uxx numBits)
+{
+	VarArrayExpand(bits, (numBits + 63) / 64);
+}
+
+// Returns bits->length*64 if there are no set bits at or after startIndex
+uxx FindNextTreeBit(const VarArray* bits, uxx startIndex)
+{
+	uxx wordIndex = startIndex / 64;
+	if (wordIndex >= bits->length) { return bits->length * 64; }
+	const u64* words = (const u64*)bits->items;
+	u64 word = words[wordIndex] & (~0ULL << (startIndex % 64));
+	while (word == 0)
+	{
+		wordIndex++;
+		if (wordIndex >= bits->length) { return bits->length * 64; }
+		word = words[wordIndex];
+	}
+	return wordIndex * 64 + CountTreeBitTrailingZeros(word);
+}
+
+// visibleBits = the union of every typeBits[t] whose flag is set
+void RebuildTreeVisibleBits(VarArray* visibleBits, const VarArray* typeBits, uxx numTypes, u8 typeFlags)
+{
+	uxx numWords = 0;
+	for (uxx tIndex = 0; tIndex < numTypes; tIndex++) { if (typeBits[tIndex].length > numWords) { numWords = typeBits[tIndex].length; } }
+	VarArrayClear(visibleBits, false);
+	if (numWords == 0) { return; }
+	u64* visibleWords = VarArrayAddMulti(u64, visibleBits, numWords);
+	NotNull(visibleWords);
+	MyMemSet(visibleWords, 0x00, sizeof(u64) * numWords);
+	for (uxx tIndex = 0; tIndex < numTypes; tIndex++)
+	{
+		if (!IsFlagSet(typeFlags, (u8)(1 << tIndex))) { continue; }
+		const u64* typeWords = (const u64*)typeBits[tIndex].items;
+		for (uxx wIndex = 0; wIndex < typeBits[tIndex].length; wIndex++) { visibleWords[wIndex] |= typeWords[wIndex]; }
+	}
+}
+
+void SetTreeVisibleTypes(SkillTree* tree, u8 nodeTypeFlags, u8 branchTypeFlags)
+{
+	NotNull(tree);
+	if (tree->visibleNodeTypes != nodeTypeFlags)
+	{
+		tree->visibleNodeTypes = nodeTypeFlags;
+		RebuildTreeVisibleBits(&tree->visibleNodeBits, &tree->nodeTypeBits[0], TreeNodeType_Count, nodeTypeFlags);
+	}
+	if (tree->visibleBranchTypes != branchTypeFlags)
+	{
+		tree->visibleBranchTypes = branchTypeFlags;
+		RebuildTreeVisibleBits(&tree->visibleBranchBits, &tree->branchTypeBits[0], TreeBranchType_Count, branchTypeFlags);
+	}
+}
+
+bool IsTreeNodeVisible(SkillTree* tree, uxx nodeIndex) { return IsTreeBitSet(&tree->visibleNodeBits, nodeIndex); }
+bool IsTreeBranchVisible(SkillTree* tree, uxx branchIndex) { return IsTreeBitSet(&tree->visibleBranchBits, branchIndex); }
+
+// +--------------------------------------------------------------+
+// |                          Statistics                          |
+// +--------------------------------------------------------------+
+// counts[index] is a number of nodes (with that degree, in that tier, etc.), the array grows to fit whatever index shows up
+void AdjustTreeStatCount(VarArray* counts, uxx index, bool increment)
+{
+	while (counts->length <= index) { *VarArrayAdd(uxx, counts) = 0; }
+	uxx* count = VarArrayGetHard(uxx, counts, index);
+	if (increment) { (*count)++; }
+	else { Assert(*count > 0); (*count)--; }
+}
+
+uxx GetTreeNodeRefsDegree(const TreeNodeRefs* nodeRefs)
+{
+	return (uxx)(nodeRefs->partitionStarts[TREE_REF_NUM_PARTITIONS] - nodeRefs->partitionStarts[0]);
+}
+
+// Path halving, every node we pass gets pointed at its grandparent so the next search is shorter
+u32 FindTreeComponent(SkillTree* tree, u32 nodeIndex)
+{
+	u32* parents = (u32*)tree->componentParents.items;
+	while (parents[nodeIndex] != nodeIndex)
+	{
+		parents[nodeIndex] = parents[parents[nodeIndex]];
+		nodeIndex = parents[nodeIndex];
+	}
+	return nodeIndex;
+}
+
+// Called when a branch between these two nodes was linked. Union by rank keeps the forest shallow
+void UnionTreeComponents(SkillTree* tree, u32 leftIndex, u32 rightIndex)
+{
+	if (tree->componentsDirty) { return; }
+	u32 leftRoot = FindTreeComponent(tree, leftIndex);
+	u32 rightRoot = FindTreeComponent(tree, rightIndex);
+	if (leftRoot == rightRoot) { return; }
+	u32* parents = (u32*)tree->componentParents.items;
+	u8* ranks = (u8*)tree->componentRanks.items;
+	if (ranks[leftRoot] < ranks[rightRoot]) { u32 swap = leftRoot; leftRoot = rightRoot; rightRoot = swap; }
+	parents[rightRoot] = leftRoot;
+	if (ranks[leftRoot] == ranks[rightRoot]) { ranks[leftRoot]++; }
+	TreeProgress* leftProgress = VarArrayGetHard(TreeProgress, &tree->componentProgress, leftRoot);
+	TreeProgress* rightProgress = VarArrayGetHard(TreeProgress, &tree->componentProgress, rightRoot);
+	leftProgress->numNodes += rightProgress->numNodes;
+	leftProgress->numLearned += rightProgress->numLearned;
+	leftProgress->numUnlocked += rightProgress->numUnlocked;
+	tree->numComponents--;
+}
+
+// Every live node starts in its own set, then every branch with both ends linked merges the sets at either end. O(N + B)
+void RebuildTreeComponents(SkillTree* tree)
+{
+	Assert(tree->referencesBaked);
+	u32* parents = (u32*)tree->componentParents.items;
+	u8* ranks = (u8*)tree->componentRanks.items;
+	for (uxx nIndex = 0; nIndex < tree->componentParents.length; nIndex++) { parents[nIndex] = (u32)nIndex; }
+	if (tree->componentRanks.length > 0) { MyMemSet(ranks, 0x00, sizeof(u8) * tree->componentRanks.length); }
+	TreeIdView nodeIds = GetTreeNodeIdsView(tree);
+	for (uxx nIndex = 0; nIndex < nodeIds.count; nIndex++)
+	{
+		TreeProgress* progress = VarArrayGetHard(TreeProgress, &tree->componentProgress, nIndex);
+		ClearPointer(progress);
+		if (TreeViewAt(nodeIds, nIndex) == 0) { continue; } //free slot
+		progress->numNodes = 1;
+		progress->numLearned = IsTreeBitSet(&tree->nodeLearnedBits, nIndex) ? 1 : 0;
+		progress->numUnlocked = (*VarArrayGetHard(u32, &tree->nodeUnmetDependencies, nIndex) == 0) ? 1 : 0;
+	}
+	tree->numComponents = tree->numNodes;
+	tree->componentsDirty = false;
+	TreeBranchView branches = GetTreeBranchesView(tree);
+	for (uxx bIndex = 0; bIndex < branches.count; bIndex++)
+	{
+		TreeBranch* branch = &TreeViewAt(branches, bIndex);
+		if (!IsTreeSlotGenerationAlive(branch->generation) || IsEmptyTreeNodeHandle(branch->fromHandle) || IsEmptyTreeNodeHandle(branch->toHandle)) { continue; }
+		UnionTreeComponents(tree, branch->fromHandle.index, branch->toHandle.index);
+	}
+}
+
+// Called whenever one of a node's Dependency parents is linked/unlinked or (un)learned, keeps the unlocked counts in step with the counter
+void AdjustTreeUnmetDependencies(SkillTree* tree, u32 nodeIndex, bool increment)
+{
+	u32* numUnmet = VarArrayGetHard(u32, &tree->nodeUnmetDependencies, nodeIndex);
+	bool wasUnlocked = (*numUnmet == 0);
+	if (increment) { (*numUnmet)++; }
+	else { Assert(*numUnmet > 0); (*numUnmet)--; }
+	bool isUnlocked = (*numUnmet == 0);
+	if (wasUnlocked == isUnlocked) { return; }
+	if (isUnlocked) { tree->numUnlockedNodes++; } else { tree->numUnlockedNodes--; }
+	if (!tree->componentsDirty)
+	{
+		TreeProgress* progress = VarArrayGetHard(TreeProgress, &tree->componentProgress, FindTreeComponent(tree, nodeIndex));
+		if (isUnlocked) { progress->numUnlocked++; } else { progress->numUnlocked--; }
+	}
+}
+
+// +--------------------------------------------------------------+
+// |                      Baked References                        |
+// +--------------------------------------------------------------+
+TreeNodeRefs* GetTreeNodeRefs(SkillTree* tree, uxx nodeIndex)
+{
+	NotNull(tree);
+	Assert(tree->referencesBaked);
+	TreeNodeRefsView nodeRefs = GetTreeNodeRefsView(tree);
+	return &TreeViewAt(nodeRefs, nodeIndex);
+}
+
+TreeRefIter NewTreeRefIter(SkillTree* tree, TreeNode* node, bool includeIncoming, bool includeOutgoing, u8 branchTypeFlags)
+{
+	NotNull(tree);
+	NotNull(node);
+	Assert(tree->referencesBaked);
+	TreeRefIter result = ZEROED;
+	result.tree = tree;
+	result.nodeIndex = GetTreeNodeIndex(tree, node);
+	for (uxx tIndex = 0; tIndex < TreeBranchType_Count; tIndex++)
+	{
+		if (!IsFlagSet(branchTypeFlags, TreeBranchTypeFlag(tIndex))) { continue; }
+		if (includeOutgoing) { result.partitionFlags |= (1u << GetTreeRefPartition(false, tIndex)); }
+		if (includeIncoming) { result.partitionFlags |= (1u << GetTreeRefPartition(true, tIndex)); }
+	}
+	result.partition = 0;
+	result.refIndex = GetTreeNodeRefs(tree, result.nodeIndex)->partitionStarts[0];
+	return result;
+}
+bool TreeRefIterStep(TreeRefIter* iter)
+{
+	NotNull(iter);
+	NotNull(iter->tree);
+	SkillTree* tree = iter->tree;
+	const TreeNodeRefs* nodeRefs = GetTreeNodeRefs(tree, iter->nodeIndex);
+	while (iter->partition < TREE_REF_NUM_PARTITIONS)
+	{
+		if (IsFlagSet(iter->partitionFlags, (1u << iter->partition)) && iter->refIndex < nodeRefs->partitionStarts[iter->partition + 1])
+		{
+			TreeReferenceView refs = GetTreeReferencesView(tree);
+			TreeBranchView branches = GetTreeBranchesView(tree);
+			TreeNodeView nodes = GetTreeNodesView(tree);
+			TreeReference* reference = &TreeViewAt(refs, iter->refIndex);
+			iter->refIndex++;
+			iter->index++;
+			iter->isIncoming = (iter->partition >= TreeBranchType_Count);
+			iter->branchType = (TreeBranchType)(iter->partition % TreeBranchType_Count);
+			iter->reference = reference;
+			iter->branch = &TreeViewAt(branches, reference->branchIndex);
+			iter->node = (reference->nodeIndex != TREE_INVALID_INDEX) ? &TreeViewAt(nodes, reference->nodeIndex) : nullptr;
+			return true;
+		}
+		iter->partition++;
+		iter->refIndex = nodeRefs->partitionStarts[iter->partition];
+	}
+	return false;
+}
+
+TreeBranch* GetBranchForNode(SkillTree* tree, TreeNode* node, bool includeIncoming, bool includeOutgoing, uxx index, TreeNode** nodeOut)
+{
+	NotNull(tree);
+	NotNull(node);
+	if (tree->referencesBaked)
+	{
+		// Outgoing partitions come before incoming ones so either (or both) directions form one contiguous range
+		const TreeNodeRefs* nodeRefs = GetTreeNodeRefs(tree, GetTreeNodeIndex(tree, node));
+		uxx firstPartition = includeOutgoing ? 0 : TreeBranchType_Count;
+		uxx endPartition = includeIncoming ? TREE_REF_NUM_PARTITIONS : TreeBranchType_Count;
+		if (firstPartition >= endPartition) { return nullptr; }
+		uxx refIndex = nodeRefs->partitionStarts[firstPartition] + index;
+		if (refIndex >= nodeRefs->partitionStarts[endPartition]) { return nullptr; }
+		TreeReference* reference = VarArrayGetHard(TreeReference, &tree->references, refIndex);
+		if (nodeOut != nullptr) { *nodeOut = (reference->nodeIndex != TREE_INVALID_INDEX) ? VarArrayGetHard(TreeNode, &tree->nodes, reference->nodeIndex) : nullptr; }
+		return VarArrayGetHard(TreeBranch, &tree->branches, reference->branchIndex);
+	}
+	else
+	{
+		uxx foundIndex = 0;
+		TreeBranchView branches = GetTreeBranchesView(tree);
+		for (uxx bIndex = 0; bIndex < branches.count; bIndex++)
+		{
+			TreeBranch* branch = &TreeViewAt(branches, bIndex);
+			if (!IsTreeSlotGenerationAlive(branch->generation)) { continue; }
+			if ((branch->toId == node->id && includeIncoming) ||
+				(branch->fromId == node->id && includeOutgoing))
+			{
+				if (foundIndex >= index)
+				{
+					if (nodeOut != nullptr) { *nodeOut = GetTreeNodeById(tree, (branch->fromId == node->id) ? branch->toId : branch->fromId); }
+					return branch;
+				}
+				foundIndex++;
+			}
+		}
+		return nullptr;
+	}
+}
+
+// Branches don't have ids, so this finds one by what it connects. When there are identical duplicates any one of them is returned.
+// O(degree of the from node) when baked, O(B) otherwise (or when the from node doesn't exist)
+TreeBranch* FindTreeBranch(SkillTree* tree, TreeBranchType type, uxx fromId, uxx toId)
+{
+	NotNull(tree);
+	TreeNode* fromNode = tree->referencesBaked ? GetTreeNodeById(tree, fromId) : nullptr;
+	if (fromNode != nullptr)
+	{
+		const TreeNodeRefs* nodeRefs = GetTreeNodeRefs(tree, GetTreeNodeIndex(tree, fromNode));
+		uxx partition = GetTreeRefPartition(false, type);
+		TreeReferenceView refs = GetTreeReferencesView(tree);
+		TreeBranchView branches = GetTreeBranchesView(tree);
+		for (uxx rIndex = nodeRefs->partitionStarts[partition]; rIndex < nodeRefs->partitionStarts[partition+1]; rIndex++)
+		{
+			TreeBranch* branch = &TreeViewAt(branches, TreeViewAt(refs, rIndex).branchIndex);
+			if (branch->toId == toId) { return branch; }
+		}
+		return nullptr;
+	}
+	else
+	{
+		TreeBranchView branches = GetTreeBranchesView(tree);
+		for (uxx bIndex = 0; bIndex < branches.count; bIndex++)
+		{
+			TreeBranch* branch = &TreeViewAt(branches, bIndex);
+			if (!IsTreeSlotGenerationAlive(branch->generation)) { continue; }
+			if (branch->type == type && branch->fromId == fromId && branch->toId == toId) { return branch; }
+		}
+		return nullptr;
+	}
+}
+
+// Returns the reference in the given partition of the node that points at branchIndex (or nullptr)
+TreeReference* FindTreeNodeReference(SkillTree* tree, uxx nodeIndex, uxx partition, uxx branchIndex)
+{
+	const TreeNodeRefs* nodeRefs = GetTreeNodeRefs(tree, nodeIndex);
+	TreeReferenceView refs = GetTreeReferencesView(tree);
+	for (uxx rIndex = nodeRefs->partitionStarts[partition]; rIndex < nodeRefs->partitionStarts[partition+1]; rIndex++)
+	{
+		if (TreeViewAt(refs, rIndex).branchIndex == branchIndex) { return &TreeViewAt(refs, rIndex); }
+	}
+	return nullptr;
+}
+
+// Moves every node's references into a fresh tightly packed array, reclaiming all holes and spare capacity
+void CompactTreeReferences(SkillTree* tree)
+{
+	NotNull(tree);
+	NotNull(tree->arena);
+	Assert(tree->referencesBaked);
+	// The blocks are packed into scratch first and then copied back, so the references array keeps its buffer (and its capacity for later growth)
+	ScratchBegin1(scratch, tree->arena);
+	TreeReference* packedRefs = (tree->numUsedReferences > 0) ? AllocArray(TreeReference, scratch, tree->numUsedReferences) : nullptr;
+	u32 numPacked = 0;
+	TreeNodeRefsView allNodeRefs = GetTreeNodeRefsView(tree);
+	for (uxx nIndex = 0; nIndex < allNodeRefs.count; nIndex++)
+	{
+		TreeNodeRefs* nodeRefs = &TreeViewAt(allNodeRefs, nIndex);
+		u32 oldStart = nodeRefs->partitionStarts[0];
+		u32 numUsed = nodeRefs->partitionStarts[TREE_REF_NUM_PARTITIONS] - oldStart;
+		if (numUsed > 0)
+		{
+			MyMemCopy(&packedRefs[numPacked], VarArrayGetHard(TreeReference, &tree->references, oldStart), sizeof(TreeReference) * numUsed);
+		}
+		for (uxx pIndex = 0; pIndex <= TREE_REF_NUM_PARTITIONS; pIndex++) { nodeRefs->partitionStarts[pIndex] = numPacked + (nodeRefs->partitionStarts[pIndex] - oldStart); }
+		nodeRefs->capacity = numUsed;
+		numPacked += numUsed;
+	}
+	Assert(numPacked == tree->numUsedReferences);
+	VarArrayClear(&tree->references, false);
+	if (numPacked > 0)
+	{
+		TreeReference* newRefs = VarArrayAddMulti(TreeReference, &tree->references, numPacked);
+		MyMemCopy(newRefs, packedRefs, sizeof(TreeReference) * numPacked);
+	}
+	ScratchEnd(scratch);
+}
+
+// Makes room for one more reference in the node's block, moving the block to the end of the references array if it's full
+void GrowTreeNodeRefs(SkillTree* tree, uxx nodeIndex)
+{
+	TreeNodeRefs* nodeRefs = GetTreeNodeRefs(tree, nodeIndex);
+	u32 oldStart = nodeRefs->partitionStarts[0];
+	u32 numUsed = nodeRefs->partitionStarts[TREE_REF_NUM_PARTITIONS] - oldStart;
+	if (numUsed < nodeRefs->capacity) { return; }
+	u32 newCapacity = (nodeRefs->capacity >= TREE_REFS_MIN_CAPACITY/2) ? nodeRefs->capacity * 2 : TREE_REFS_MIN_CAPACITY;
+	if ((uxx)oldStart + nodeRefs->capacity == tree->references.length && nodeRefs->capacity > 0)
+	{
+		// We are the last block in the array so we can simply extend in place
+		VarArrayAddMulti(TreeReference, &tree->references, newCapacity - nodeRefs->capacity);
+		nodeRefs->capacity = newCapacity;
+		return;
+	}
+	
+	u32 newStart = (u32)tree->references.length;
+	VarArrayAddMulti(TreeReference, &tree->references, newCapacity);
+	nodeRefs = GetTreeNodeRefs(tree, nodeIndex);
+	if (numUsed > 0)
+	{
+		MyMemCopy(VarArrayGetHard(TreeReference, &tree->references, newStart), VarArrayGetHard(TreeReference, &tree->references, oldStart), sizeof(TreeReference) * numUsed);
+	}
+	for (uxx pIndex = 0; pIndex <= TREE_REF_NUM_PARTITIONS; pIndex++) { nodeRefs->partitionStarts[pIndex] = newStart + (nodeRefs->partitionStarts[pIndex] - oldStart); }
+	nodeRefs->capacity = newCapacity;
+}
+
+// Partitions are kept in order within the node's block. To make room at the end of partition p we rotate
+// each following partition by one slot (moving its first item to its end) which costs O(partitions) rather than O(degree)
+void AddTreeNodeReference(SkillTree* tree, uxx nodeIndex, uxx partition, u32 branchIndex, u32 otherNodeIndex)
+{
+	Assert(partition < TREE_REF_NUM_PARTITIONS);
+	GrowTreeNodeRefs(tree, nodeIndex);
+	TreeNodeRefs* nodeRefs = GetTreeNodeRefs(tree, nodeIndex);
+	TreeReference* refs = (TreeReference*)tree->references.items;
+	for (uxx pIndex = TREE_REF_NUM_PARTITIONS; pIndex > partition + 1; pIndex--)
+	{
+		u32 partitionStart = nodeRefs->partitionStarts[pIndex-1];
+		u32 partitionEnd = nodeRefs->partitionStarts[pIndex];
+		if (partitionEnd > partitionStart) { refs[partitionEnd] = refs[partitionStart]; }
+		nodeRefs->partitionStarts[pIndex]++;
+	}
+	u32 newIndex = nodeRefs->partitionStarts[partition+1];
+	nodeRefs->partitionStarts[partition+1]++;
+	refs[newIndex].branchIndex = branchIndex;
+	refs[newIndex].nodeIndex = otherNodeIndex;
+	if (partition == GetTreeRefPartition(true, TreeBranchType_Dependency) && otherNodeIndex != TREE_INVALID_INDEX && !IsTreeBitSet(&tree->nodeLearnedBits, otherNodeIndex))
+	{
+		AdjustTreeUnmetDependencies(tree, (u32)nodeIndex, true);
+	}
+	tree->numUsedReferences++;
+	uxx newDegree = GetTreeNodeRefsDegree(nodeRefs);
+	AdjustTreeStatCount(&tree->degreeCounts, newDegree-1, false);
+	AdjustTreeStatCount(&tree->degreeCounts, newDegree, true);
+	StampTreeNodeRefsPage(tree, nodeIndex);
+}
+
+// The inverse of AddTreeNodeReference: fill the hole with the last item of the partition, then the hole
+// becomes the first slot of the next partition, which we fill with that partition's last item, and so on
+void RemoveTreeNodeReference(SkillTree* tree, uxx nodeIndex, uxx partition, u32 branchIndex)
+{
+	Assert(partition < TREE_REF_NUM_PARTITIONS);
+	TreeReference* reference = FindTreeNodeReference(tree, nodeIndex, partition, branchIndex);
+	NotNull(reference);
+	if (partition == GetTreeRefPartition(true, TreeBranchType_Dependency) && reference->nodeIndex != TREE_INVALID_INDEX && !IsTreeBitSet(&tree->nodeLearnedBits, reference->nodeIndex))
+	{
+		AdjustTreeUnmetDependencies(tree, (u32)nodeIndex, false);
+	}
+	TreeNodeRefs* nodeRefs = GetTreeNodeRefs(tree, nodeIndex);
+	TreeReference* refs = (TreeReference*)tree->references.items;
+	u32 lastInPartition = nodeRefs->partitionStarts[partition+1] - 1;
+	*reference = refs[lastInPartition];
+	nodeRefs->partitionStarts[partition+1]--;
+	for (uxx pIndex = partition + 1; pIndex < TREE_REF_NUM_PARTITIONS; pIndex++)
+	{
+		u32 partitionStart = nodeRefs->partitionStarts[pIndex];
+		u32 partitionEnd = nodeRefs->partitionStarts[pIndex+1];
+		if (partitionEnd > partitionStart + 1) { refs[partitionStart] = refs[partitionEnd-1]; }
+		nodeRefs->partitionStarts[pIndex+1]--;
+	}
+	tree->numUsedReferences--;
+	uxx newDegree = GetTreeNodeRefsDegree(nodeRefs);
+	AdjustTreeStatCount(&tree->degreeCounts, newDegree+1, false);
+	AdjustTreeStatCount(&tree->degreeCounts, newDegree, true);
+	StampTreeNodeRefsPage(tree, nodeIndex);
+}
+
+void CompactTreeReferencesIfNeeded(SkillTree* tree)
+{
+	uxx numUnused = tree->references.length - tree->numUsedReferences;
+	if (numUnused > TREE_REFS_COMPACT_MIN_UNUSED && numUnused > tree->numUsedReferences) { CompactTreeReferences(tree); }
+}
+
+// Every empty fromHandle/toHandle in a baked tree goes through these so it can be found again by the id it's waiting for.
+// Id 0 never belongs to a node so those ends are only counted
+void AddTreeDanglingEnd(SkillTree* tree, uxx branchIndex, bool isToEnd, uxx missingId)
+{
+	tree->numDanglingBranchEnds++;
+	if (missingId == ID_TABLE_EMPTY_KEY) { return; }
+	u32 endIndex = (u32)(branchIndex*2 + (isToEnd ? 1 : 0));
+	while (tree->danglingEnds.length <= endIndex) { VarArrayAdd(TreeDanglingEnd, &tree->danglingEnds); }
+	TreeDanglingEnd* end = VarArrayGetHard(TreeDanglingEnd, &tree->danglingEnds, endIndex);
+	uxx headIndex = 0;
+	end->prev = TREE_INVALID_INDEX;
+	end->next = IdTableFind(&tree->danglingEndLookup, missingId, &headIndex) ? (u32)headIndex : TREE_INVALID_INDEX;
+	if (end->next != TREE_INVALID_INDEX) { VarArrayGetHard(TreeDanglingEnd, &tree->danglingEnds, end->next)->prev = endIndex; }
+	IdTableSet(&tree->danglingEndLookup, missingId, endIndex);
+}
+void RemoveTreeDanglingEnd(SkillTree* tree, uxx branchIndex, bool isToEnd, uxx missingId)
+{
+	Assert(tree->numDanglingBranchEnds > 0);
+	tree->numDanglingBranchEnds--;
+	if (missingId == ID_TABLE_EMPTY_KEY) { return; }
+	u32 endIndex = (u32)(branchIndex*2 + (isToEnd ? 1 : 0));
+	TreeDanglingEnd* end = VarArrayGetHard(TreeDanglingEnd, &tree->danglingEnds, endIndex);
+	if (end->prev != TREE_INVALID_INDEX) { VarArrayGetHard(TreeDanglingEnd, &tree->danglingEnds, end->prev)->next = end->next; }
+	else if (end->next != TREE_INVALID_INDEX) { IdTableSet(&tree->danglingEndLookup, missingId, end->next); }
+	else { bool removedLookup = IdTableRemove(&tree->danglingEndLookup, missingId); Assert(removedLookup); }
+	if (end->next != TREE_INVALID_INDEX) { VarArrayGetHard(TreeDanglingEnd, &tree->danglingEnds, end->next)->prev = end->prev; }
+	end->prev = TREE_INVALID_INDEX;
+	end->next = TREE_INVALID_INDEX;
+}
+
+void UnbakeTreeReferences(SkillTree* tree)
+{
+	NotNull(tree);
+	NotNull(tree->arena);
+	Assert(tree->referencesBaked);
+	
+	VarArrayClear(&tree->nodeRefs, false);
+	VarArrayClear(&tree->references, false);
+	VarArrayClear(&tree->nodeTiers, false);
+	VarArrayClear(&tree->topoOrder, false);
+	VarArrayClear(&tree->cycleSearchMarks, false);
+	VarArrayClear(&tree->degreeCounts, false);
+	VarArrayClear(&tree->tierCounts, false);
+	VarArrayClear(&tree->componentParents, false);
+	VarArrayClear(&tree->componentRanks, false);
+	VarArrayClear(&tree->componentProgress, false);
+	VarArrayClear(&tree->nodeUnmetDependencies, false);
+	tree->numUnlockedNodes = 0;
+	tree->numCyclicNodes = 0;
+	tree->numUsedReferences = 0;
+	tree->numDanglingBranchEnds = 0;
+	ClearIdTable(&tree->danglingEndLookup);
+	VarArrayClear(&tree->danglingEnds, false);
+	TreeBranchView branches = GetTreeBranchesView(tree);
+	for (uxx bIndex = 0; bIndex < branches.count; bIndex++)
+	{
+		TreeViewAt(branches, bIndex).fromHandle = TreeNodeHandle_Empty;
+		TreeViewAt(branches, bIndex).toHandle = TreeNodeHandle_Empty;
+	}
+	MarkAllTreeBranchesChanged(tree);
+	StampAllTreeNodeRefsPages(tree);
+	
+	tree->referencesBaked = false;
+}
+// Builds the adjacency in two passes: first we count how many references land in each partition of
+// each node, then a prefix sum turns those counts into start indices and a second pass fills them in.
+// The result is tightly packed (no spare capacity) until edits start growing individual nodes
+void BakeTreeReferences(SkillTree* tree)
+{
+	NotNull(tree);
+	NotNull(tree->arena);
+	Assert(!tree->referencesBaked);
+	Assert(tree->nodes.length < TREE_INVALID_INDEX && tree->branches.length < TREE_INVALID_INDEX);
+	tree->referencesBaked = true;
+	tree->dependencyVersion++;
+	MarkAllTreeBranchesChanged(tree);
+	StampAllTreeNodeRefsPages(tree);
+	
+	// Everything below fills the (empty) baked arrays, reusing whatever buffers they had the last time we were baked
+	if (tree->nodes.length > 0)
+	{
+		TreeNodeRefs* allNodeRefs = VarArrayAddMulti(TreeNodeRefs, &tree->nodeRefs, tree->nodes.length);
+		MyMemSet(allNodeRefs, 0x00, sizeof(TreeNodeRefs) * tree->nodes.length);
+	}
+	
+	// Pass 1: Resolve pointers and count references per partition (counts are stored one slot ahead so the prefix sum below produces start indices)
+	uxx numReferences = 0;
+	tree->numDanglingBranchEnds = 0;
+	TreeBranchView branches = GetTreeBranchesView(tree);
+	TreeNodeRefsView allNodeRefs = GetTreeNodeRefsView(tree);
+	for (uxx bIndex = 0; bIndex < branches.count; bIndex++)
+	{
+		TreeBranch* branch = &TreeViewAt(branches, bIndex);
+		if (!IsTreeSlotGenerationAlive(branch->generation)) { continue; }
+		Assert(branch->type < TreeBranchType_Count);
+		branch->fromHandle = GetTreeNodeHandle(tree, GetTreeNodeById(tree, branch->fromId));
+		branch->toHandle = GetTreeNodeHandle(tree, GetTreeNodeById(tree, branch->toId));
+		if (!IsEmptyTreeNodeHandle(branch->fromHandle))
+		{
+			TreeViewAt(allNodeRefs, branch->fromHandle.index).partitionStarts[GetTreeRefPartition(false, branch->type) + 1]++;
+			numReferences++;
+		}
+		else { AddTreeDanglingEnd(tree, bIndex, false, branch->fromId); }
+		if (!IsEmptyTreeNodeHandle(branch->toHandle))
+		{
+			TreeViewAt(allNodeRefs, branch->toHandle.index).partitionStarts[GetTreeRefPartition(true, branch->type) + 1]++;
+			numReferences++;
+		}
+		else { AddTreeDanglingEnd(tree, bIndex, true, branch->toId); }
+	}
+	Assert(numReferences < TREE_INVALID_INDEX);
+	u32 runningTotal = 0;
+	for (uxx nIndex = 0; nIndex < allNodeRefs.count; nIndex++)
+	{
+		TreeNodeRefs* nodeRefs = &TreeViewAt(allNodeRefs, nIndex);
+		nodeRefs->partitionStarts[0] = runningTotal;
+		for (uxx pIndex = 1; pIndex <= TREE_REF_NUM_PARTITIONS; pIndex++) { nodeRefs->partitionStarts[pIndex] += nodeRefs->partitionStarts[pIndex-1]; }
+		nodeRefs->capacity = nodeRefs->partitionStarts[TREE_REF_NUM_PARTITIONS] - runningTotal;
+		runningTotal = nodeRefs->partitionStarts[TREE_REF_NUM_PARTITIONS];
+	}
+	Assert(runningTotal == numReferences);
+	TreeIdView nodeIds = GetTreeNodeIdsView(tree);
+	for (uxx nIndex = 0; nIndex < nodeIds.count; nIndex++)
+	{
+		if (TreeViewAt(nodeIds, nIndex) != 0) { AdjustTreeStatCount(&tree->degreeCounts, GetTreeNodeRefsDegree(&TreeViewAt(allNodeRefs, nIndex)), true); }
+	}
+	
+	// Pass 2: Fill the references, using a copy of the start indices as write cursors
+	if (numReferences > 0) { VarArrayAddMulti(TreeReference, &tree->references, numReferences); }
+	tree->numUsedReferences = numReferences;
+	TreeReference* refs = (TreeReference*)tree->references.items;
+	ScratchBegin1(scratch, tree->arena);
+	u32* cursors = (tree->nodes.length > 0) ? AllocArray(u32, scratch, tree->nodes.length * TREE_REF_NUM_PARTITIONS) : nullptr;
+	for (uxx nIndex = 0; nIndex < allNodeRefs.count; nIndex++)
+	{
+		MyMemCopy(&cursors[nIndex * TREE_REF_NUM_PARTITIONS], &TreeViewAt(allNodeRefs, nIndex).partitionStarts[0], sizeof(u32) * TREE_REF_NUM_PARTITIONS);
+	}
+	for (uxx bIndex = 0; bIndex < branches.count; bIndex++)
+	{
+		TreeBranch* branch = &TreeViewAt(branches, bIndex);
+		if (!IsTreeSlotGenerationAlive(branch->generation)) { continue; }
+		u32 fromIndex = !IsEmptyTreeNodeHandle(branch->fromHandle) ? branch->fromHandle.index : TREE_INVALID_INDEX;
+		u32 toIndex = !IsEmptyTreeNodeHandle(branch->toHandle) ? branch->toHandle.index : TREE_INVALID_INDEX;
+		if (fromIndex != TREE_INVALID_INDEX)
+		{
+			TreeReference* outgoingReference = &refs[cursors[fromIndex * TREE_REF_NUM_PARTITIONS + GetTreeRefPartition(false, branch->type)]++];
+			outgoingReference->branchIndex = (u32)bIndex;
+			outgoingReference->nodeIndex = toIndex;
+		}
+		if (toIndex != TREE_INVALID_INDEX)
+		{
+			TreeReference* incomingReference = &refs[cursors[toIndex * TREE_REF_NUM_PARTITIONS + GetTreeRefPartition(true, branch->type)]++];
+			incomingReference->branchIndex = (u32)bIndex;
+			incomingReference->nodeIndex = fromIndex;
+		}
+	}
+	ScratchEnd(scratch);
+	
+	if (tree->nodes.length > 0) { VarArrayAddMulti(u32, &tree->nodeUnmetDependencies, tree->nodes.length); }
+	tree->numUnlockedNodes = 0;
+	uxx dependencyPartition = GetTreeRefPartition(true, TreeBranchType_Dependency);
+	for (uxx nIndex = 0; nIndex < allNodeRefs.count; nIndex++)
+	{
+		TreeNodeRefs* nodeRefs = &TreeViewAt(allNodeRefs, nIndex);
+		u32 numUnmet = 0;
+		for (uxx rIndex = nodeRefs->partitionStarts[dependencyPartition]; rIndex < nodeRefs->partitionStarts[dependencyPartition+1]; rIndex++)
+		{
+			if (refs[rIndex].nodeIndex != TREE_INVALID_INDEX && !IsTreeBitSet(&tree->nodeLearnedBits, refs[rIndex].nodeIndex)) { numUnmet++; }
+		}
+		*VarArrayGetHard(u32, &tree->nodeUnmetDependencies, nIndex) = numUnmet;
+		if (numUnmet == 0 && TreeViewAt(nodeIds, nIndex) != 0) { tree->numUnlockedNodes++; }
+	}
+	
+	// Tiers are calculated lazily the first time somebody asks for them
+	if (tree->nodes.length > 0)
+	{
+		u32* allNodeTiers = VarArrayAddMulti(u32, &tree->nodeTiers, tree->nodes.length);
+		MyMemSet(allNodeTiers, 0x00, sizeof(u32) * tree->nodes.length);
+	}
+	if (tree->nodes.length > 0)
+	{
+		u32* allMarks = VarArrayAddMulti(u32, &tree->cycleSearchMarks, tree->nodes.length);
+		MyMemSet(allMarks, 0x00, sizeof(u32) * tree->nodes.length);
+	}
+	tree->cycleSearchStamp = 0;
+	tree->tiersDirty = true;
+	tree->topoOrderDirty = true;
+	tree->numCyclicNodes = 0;
+	
+	// Components are rebuilt lazily too (see GetTreeStats)
+	if (tree->nodes.length > 0)
+	{
+		VarArrayAddMulti(u32, &tree->componentParents, tree->nodes.length);
+		VarArrayAddMulti(u8, &tree->componentRanks, tree->nodes.length);
+		VarArrayAddMulti(TreeProgress, &tree->componentProgress, tree->nodes.length);
+	}
+	tree->componentsDirty = true;
+}
+
+// Hooks up the references for a branch that was just added to (or just found a node in) a baked tree
+void LinkTreeBranchReferences(SkillTree* tree, uxx branchIndex)
+{
+	TreeBranchView branches = GetTreeBranchesView(tree);
+	TreeBranch* branch = &TreeViewAt(branches, branchIndex);
+	u32 fromIndex = !IsEmptyTreeNodeHandle(branch->fromHandle) ? branch->fromHandle.index : TREE_INVALID_INDEX;
+	u32 toIndex = !IsEmptyTreeNodeHandle(branch->toHandle) ? branch->toHandle.index : TREE_INVALID_INDEX;
+	if (fromIndex != TREE_INVALID_INDEX) { AddTreeNodeReference(tree, fromIndex, GetTreeRefPartition(false, branch->type), (u32)branchIndex, toIndex); }
+	if (toIndex != TREE_INVALID_INDEX) { AddTreeNodeReference(tree, toIndex, GetTreeRefPartition(true, branch->type), (u32)branchIndex, fromIndex); }
+	if (fromIndex != TREE_INVALID_INDEX && toIndex != TREE_INVALID_INDEX) { UnionTreeComponents(tree, fromIndex, toIndex); }
+}
+
+// +--------------------------------------------------------------+
+// |                      Dependency Tiers                        |
+// +--------------------------------------------------------------+
+// Keeps tierCounts in step with a node's tier changing. RecalculateTreeTiers rebuilds the counts so there's nothing to do while the tiers are dirty
+void MoveTreeTierCount(SkillTree* tree, u32 oldTier, u32 newTier)
+{
+	if (tree->tiersDirty) { return; }
+	if (oldTier != TREE_INVALID_TIER) { AdjustTreeStatCount(&tree->tierCounts, oldTier, false); }
+	if (newTier != TREE_INVALID_TIER) { AdjustTreeStatCount(&tree->tierCounts, newTier, true); }
+}
+
+// Full recalculation using Kahn's algorithm, O(N+B). Nodes that never run out of unresolved dependencies are part of a cycle (or downstream of one)
+void RecalculateTreeTiers(SkillTree* tree)
+{
+	NotNull(tree);
+	Assert(tree->referencesBaked);
+	ScratchBegin1(scratch, tree->arena);
+	u32* tiers = (u32*)tree->nodeTiers.items;
+	u32* numUnresolved = (tree->nodes.length > 0) ? AllocArray(u32, scratch, tree->nodes.length) : nullptr;
+	u32* queue = (tree->nodes.length > 0) ? AllocArray(u32, scratch, tree->nodes.length) : nullptr;
+	uxx queueLength = 0;
+	uxx incomingPartition = GetTreeRefPartition(true, TreeBranchType_Dependency);
+	uxx outgoingPartition = GetTreeRefPartition(false, TreeBranchType_Dependency);
+	TreeIdView nodeIds = GetTreeNodeIdsView(tree);
+	TreeNodeRefsView allNodeRefs = GetTreeNodeRefsView(tree);
+	TreeReferenceView refs = GetTreeReferencesView(tree);
+	
+	for (uxx nIndex = 0; nIndex < nodeIds.count; nIndex++)
+	{
+		tiers[nIndex] = 0;
+		if (TreeViewAt(nodeIds, nIndex) == 0) { continue; } //free slot
+		const TreeNodeRefs* nodeRefs = &TreeViewAt(allNodeRefs, nIndex);
+		numUnresolved[nIndex] = 0;
+		for (uxx rIndex = nodeRefs->partitionStarts[incomingPartition]; rIndex < nodeRefs->partitionStarts[incomingPartition+1]; rIndex++)
+		{
+			if (TreeViewAt(refs, rIndex).nodeIndex != TREE_INVALID_INDEX) { numUnresolved[nIndex]++; }
+		}
+		if (numUnresolved[nIndex] == 0) { queue[queueLength++] = (u32)nIndex; }
+	}
+	
+	for (uxx qIndex = 0; qIndex < queueLength; qIndex++)
+	{
+		u32 nodeIndex = queue[qIndex];
+		const TreeNodeRefs* nodeRefs = &TreeViewAt(allNodeRefs, nodeIndex);
+		for (uxx rIndex = nodeRefs->partitionStarts[outgoingPartition]; rIndex < nodeRefs->partitionStarts[outgoingPartition+1]; rIndex++)
+		{
+			u32 dependentIndex = TreeViewAt(refs, rIndex).nodeIndex;
+			if (dependentIndex == TREE_INVALID_INDEX) { continue; }
+			if (tiers[dependentIndex] < tiers[nodeIndex] + 1) { tiers[dependentIndex] = tiers[nodeIndex] + 1; }
+			numUnresolved[dependentIndex]--;
+			if (numUnresolved[dependentIndex] == 0) { queue[queueLength++] = dependentIndex; }
+		}
+	}
+	
+	tree->numCyclicNodes = tree->numNodes - queueLength;
+	if (tree->numCyclicNodes > 0)
+	{
+		for (uxx nIndex = 0; nIndex < nodeIds.count; nIndex++)
+		{
+			if (TreeViewAt(nodeIds, nIndex) != 0 && numUnresolved[nIndex] > 0) { tiers[nIndex] = TREE_INVALID_TIER; }
+		}
+	}
+	VarArrayClear(&tree->tierCounts, false);
+	for (uxx nIndex = 0; nIndex < nodeIds.count; nIndex++)
+	{
+		if (TreeViewAt(nodeIds, nIndex) != 0 && tiers[nIndex] != TREE_INVALID_TIER) { AdjustTreeStatCount(&tree->tierCounts, tiers[nIndex], true); }
+	}
+	tree->tiersDirty = false;
+	tree->topoOrderDirty = true;
+	ScratchEnd(scratch);
 }
 
-void FreeTreeBranch(SkillTree* tree, TreeBranch* branch)
+// Returns what the node's tier should be based on the current tiers of its dependencies
+u32 CalculateTreeNodeTier(SkillTree* tree, uxx nodeIndex)
 {
-	NotNull(tree);
-	NotNull(tree->arena);
-	NotNull(branch);
-	FreeStr8(tree->arena, &branch->name);
-	ClearPointer(branch);
+	const u32* tiers = (const u32*)tree->nodeTiers.items;
+	const TreeNodeRefs* nodeRefs = GetTreeNodeRefs(tree, nodeIndex);
+	uxx incomingPartition = GetTreeRefPartition(true, TreeBranchType_Dependency);
+	TreeReferenceView refs = GetTreeReferencesView(tree);
+	u32 result = 0;
+	for (uxx rIndex = nodeRefs->partitionStarts[incomingPartition]; rIndex < nodeRefs->partitionStarts[incomingPartition+1]; rIndex++)
+	{
+		u32 dependencyIndex = TreeViewAt(refs, rIndex).nodeIndex;
+		if (dependencyIndex == TREE_INVALID_INDEX) { continue; }
+		if (tiers[dependencyIndex] == TREE_INVALID_TIER) { return TREE_INVALID_TIER; }
+		if (result < tiers[dependencyIndex] + 1) { result = tiers[dependencyIndex] + 1; }
+	}
+	return result;
 }
 
-void FreeSkillTree(SkillTree* tree)
+// Called when a Dependency from dependencyIndex to dependentIndex was linked. Only walks nodes whose tier actually goes up.
+// If the walk makes it back around to dependencyIndex the new branch closed a cycle and we fall back to a full recalculation
+void RaiseTreeNodeTiers(SkillTree* tree, u32 dependencyIndex, u32 dependentIndex)
 {
-	NotNull(tree);
-	if (tree->arena != nullptr)
+	tree->dependencyVersion++;
+	if (tree->tiersDirty) { return; }
+	if (tree->numCyclicNodes > 0 || dependencyIndex == dependentIndex) { tree->tiersDirty = true; return; }
+	u32* tiers = (u32*)tree->nodeTiers.items;
+	if (tiers[dependentIndex] >= tiers[dependencyIndex] + 1) { return; }
+	MoveTreeTierCount(tree, tiers[dependentIndex], tiers[dependencyIndex] + 1);
+	tiers[dependentIndex] = tiers[dependencyIndex] + 1;
+	tree->topoOrderDirty = true;
+	
+	ScratchBegin1(scratch, tree->arena);
+	VarArray queue;
+	InitVarArray(u32, &queue, scratch);
+	*VarArrayAdd(u32, &queue) = dependentIndex;
+	uxx outgoingPartition = GetTreeRefPartition(false, TreeBranchType_Dependency);
+	TreeNodeRefsView allNodeRefs = GetTreeNodeRefsView(tree);
+	TreeReferenceView refs = GetTreeReferencesView(tree);
+	for (uxx qIndex = 0; qIndex < queue.length && !tree->tiersDirty; qIndex++)
 	{
-		VarArrayLoop(&tree->nodes, nIndex)
+		u32 nodeIndex = ((u32*)queue.items)[qIndex];
+		const TreeNodeRefs* nodeRefs = &TreeViewAt(allNodeRefs, nodeIndex);
+		for (uxx rIndex = nodeRefs->partitionStarts[outgoingPartition]; rIndex < nodeRefs->partitionStarts[outgoingPartition+1]; rIndex++)
 		{
-			VarArrayLoopGet(TreeNode, node, &tree->nodes, nIndex);
-			FreeTreeNode(tree, node);
-			if (tree->referencesBaked) { FreeVarArray(&node->references); }
+			u32 childIndex = TreeViewAt(refs, rIndex).nodeIndex;
+			if (childIndex == TREE_INVALID_INDEX) { continue; }
+			if (childIndex == dependencyIndex) { tree->tiersDirty = true; break; }
+			if (tiers[childIndex] < tiers[nodeIndex] + 1)
+			{
+				MoveTreeTierCount(tree, tiers[childIndex], tiers[nodeIndex] + 1);
+				tiers[childIndex] = tiers[nodeIndex] + 1;
+				*VarArrayAdd(u32, &queue) = childIndex;
+			}
 		}
-		FreeVarArray(&tree->nodes);
-		VarArrayLoop(&tree->branches, bIndex)
+	}
+	ScratchEnd(scratch);
+}
+
+// Called when one of the dependencies of dependentIndex went away (the reference is already gone or marked TREE_INVALID_INDEX).
+// Only walks nodes whose tier actually goes down
+void LowerTreeNodeTiers(SkillTree* tree, u32 dependentIndex)
+{
+	tree->dependencyVersion++;
+	if (tree->tiersDirty) { return; }
+	if (tree->numCyclicNodes > 0) { tree->tiersDirty = true; return; }
+	u32* tiers = (u32*)tree->nodeTiers.items;
+	
+	ScratchBegin1(scratch, tree->arena);
+	VarArray queue;
+	InitVarArray(u32, &queue, scratch);
+	*VarArrayAdd(u32, &queue) = dependentIndex;
+	uxx outgoingPartition = GetTreeRefPartition(false, TreeBranchType_Dependency);
+	TreeNodeRefsView allNodeRefs = GetTreeNodeRefsView(tree);
+	TreeReferenceView refs = GetTreeReferencesView(tree);
+	for (uxx qIndex = 0; qIndex < queue.length; qIndex++)
+	{
+		u32 nodeIndex = ((u32*)queue.items)[qIndex];
+		u32 oldTier = tiers[nodeIndex];
+		u32 newTier = CalculateTreeNodeTier(tree, nodeIndex);
+		if (newTier >= oldTier) { continue; }
+		MoveTreeTierCount(tree, oldTier, newTier);
+		tiers[nodeIndex] = newTier;
+		tree->topoOrderDirty = true;
+		// Only dependents that were exactly one tier above us could have been getting their tier from us
+		const TreeNodeRefs* nodeRefs = &TreeViewAt(allNodeRefs, nodeIndex);
+		for (uxx rIndex = nodeRefs->partitionStarts[outgoingPartition]; rIndex < nodeRefs->partitionStarts[outgoingPartition+1]; rIndex++)
 		{
-			VarArrayLoopGet(TreeBranch, branch, &tree->branches, bIndex);
-			FreeTreeBranch(tree, branch);
+			u32 childIndex = TreeViewAt(refs, rIndex).nodeIndex;
+			if (childIndex != TREE_INVALID_INDEX && tiers[childIndex] == oldTier + 1) { *VarArrayAdd(u32, &queue) = childIndex; }
 		}
-		FreeVarArray(&tree->branches);
 	}
-	ClearPointer(tree);
+	ScratchEnd(scratch);
 }
 
-void InitSkillTree(Arena* arena, SkillTree* treeOut)
+// Returns TREE_INVALID_TIER for nodes in (or downstream of) a Dependency cycle
+u32 GetTreeNodeTier(SkillTree* tree, const TreeNode* node)
 {
-	NotNull(arena);
-	NotNull(treeOut);
-	ClearPointer(treeOut);
-	treeOut->arena = arena;
-	treeOut->nextNodeId = 1;
-	treeOut->referencesBaked = false;
-	InitVarArray(TreeNode, &treeOut->nodes, arena);
-	InitVarArray(TreeBranch, &treeOut->branches, arena);
+	NotNull(tree);
+	NotNull(node);
+	Assert(tree->referencesBaked);
+	if (tree->tiersDirty) { RecalculateTreeTiers(tree); }
+	return *VarArrayGetHard(u32, &tree->nodeTiers, GetTreeNodeIndex(tree, node));
 }
 
-TreeNode* GetTreeNodeById(SkillTree* tree, uxx nodeId)
+// +--------------------------------------------------------------+
+// |                       Cycle Detection                        |
+// +--------------------------------------------------------------+
+// Checks if adding a Dependency from dependencyIndex to dependentIndex would create a cycle, which is true if there's already a path back
+// from dependentIndex to dependencyIndex. Tiers strictly increase along every path so we only have to search nodes below the
+// dependency's tier, and if the dependency's tier is already lower than the dependent's there can't be a path at all (no search).
+// Nodes are marked with a stamp rather than a cleared visited array so the cost only depends on the size of the region we search
+bool WouldTreeDependencyCloseCycle(SkillTree* tree, u32 dependencyIndex, u32 dependentIndex)
 {
-	VarArrayLoop(&tree->nodes, nIndex)
+	NotNull(tree);
+	Assert(tree->referencesBaked);
+	if (dependencyIndex == dependentIndex) { return true; }
+	if (tree->tiersDirty) { RecalculateTreeTiers(tree); }
+	const u32* tiers = (const u32*)tree->nodeTiers.items;
+	bool boundedByTiers = (tree->numCyclicNodes == 0); //if there's already a cycle the tiers can't be trusted and we have to search everything
+	if (boundedByTiers && tiers[dependencyIndex] < tiers[dependentIndex]) { return false; }
+	u32 maxTier = tiers[dependencyIndex];
+	
+	u32* marks = (u32*)tree->cycleSearchMarks.items;
+	tree->cycleSearchStamp++;
+	if (tree->cycleSearchStamp == 0)
 	{
-		VarArrayLoopGet(TreeNode, node, &tree->nodes, nIndex);
-		if (node->id == nodeId) { return node; }
+		MyMemSet(marks, 0x00, sizeof(u32) * tree->cycleSearchMarks.length);
+		tree->cycleSearchStamp = 1;
 	}
-	return nullptr;
-}
-TreeBranch* GetTreeBranchById(SkillTree* tree, uxx nodeId, uxx index)
-{
-	uxx foundIndex = 0;
-	VarArrayLoop(&tree->branches, bIndex)
+	u32 stamp = tree->cycleSearchStamp;
+	
+	ScratchBegin1(scratch, tree->arena);
+	VarArray stack;
+	InitVarArray(u32, &stack, scratch);
+	*VarArrayAdd(u32, &stack) = dependentIndex;
+	marks[dependentIndex] = stamp;
+	uxx outgoingPartition = GetTreeRefPartition(false, TreeBranchType_Dependency);
+	TreeNodeRefsView allNodeRefs = GetTreeNodeRefsView(tree);
+	TreeReferenceView refs = GetTreeReferencesView(tree);
+	bool result = false;
+	while (stack.length > 0 && !result)
 	{
-		VarArrayLoopGet(TreeBranch, branch, &tree->branches, bIndex);
-		if (branch->fromId == nodeId || branch->toId == nodeId)
+		u32 nodeIndex = *VarArrayGetLast(u32, &stack);
+		VarArrayRemoveAt(u32, &stack, stack.length-1);
+		const TreeNodeRefs* nodeRefs = &TreeViewAt(allNodeRefs, nodeIndex);
+		for (uxx rIndex = nodeRefs->partitionStarts[outgoingPartition]; rIndex < nodeRefs->partitionStarts[outgoingPartition+1]; rIndex++)
 		{
-			if (foundIndex >= index) { return branch; }
-			foundIndex++;
+			u32 childIndex = TreeViewAt(refs, rIndex).nodeIndex;
+			if (childIndex == TREE_INVALID_INDEX || marks[childIndex] == stamp) { continue; }
+			if (childIndex == dependencyIndex) { result = true; break; }
+			if (boundedByTiers && tiers[childIndex] >= maxTier) { continue; }
+			marks[childIndex] = stamp;
+			*VarArrayAdd(u32, &stack) = childIndex;
 		}
 	}
-	return nullptr;
+	ScratchEnd(scratch);
+	return result;
 }
 
-TreeBranch* GetBranchForNode(SkillTree* tree, TreeNode* node, bool includeIncoming, bool includeOutgoing, uxx index, TreeNode** nodeOut)
+// Finds a set of Dependency branches that, if removed, would leave no cycles (the back edges of a depth first search through the nodes
+// that are in or downstream of a cycle). Appends TreeBranchHandles to branchHandlesOut and returns how many were added
+uxx FindTreeDependencyCycleBranches(SkillTree* tree, VarArray* branchHandlesOut)
 {
 	NotNull(tree);
-	NotNull(node);
-	if (tree->referencesBaked)
+	NotNull(branchHandlesOut);
+	Assert(tree->referencesBaked);
+	if (tree->tiersDirty) { RecalculateTreeTiers(tree); }
+	if (tree->numCyclicNodes == 0) { return 0; }
+	const u32* tiers = (const u32*)tree->nodeTiers.items;
+	uxx outgoingPartition = GetTreeRefPartition(false, TreeBranchType_Dependency);
+	uxx result = 0;
+	
+	ScratchBegin1(scratch, tree->arena);
+	u8* states = AllocArray(u8, scratch, tree->nodes.length); //0 = not visited, 1 = on the stack, 2 = done
+	MyMemSet(states, 0x00, sizeof(u8) * tree->nodes.length);
+	u32* stackNodes = AllocArray(u32, scratch, tree->nodes.length);
+	u32* stackCursors = AllocArray(u32, scratch, tree->nodes.length);
+	TreeIdView nodeIds = GetTreeNodeIdsView(tree);
+	TreeNodeRefsView allNodeRefs = GetTreeNodeRefsView(tree);
+	TreeReferenceView refs = GetTreeReferencesView(tree);
+	TreeBranchView branches = GetTreeBranchesView(tree);
+	for (uxx nIndex = 0; nIndex < nodeIds.count; nIndex++)
 	{
-		uxx foundIndex = 0;
-		VarArrayLoop(&node->references, rIndex)
+		if (TreeViewAt(nodeIds, nIndex) == 0 || tiers[nIndex] != TREE_INVALID_TIER || states[nIndex] != 0) { continue; }
+		uxx stackDepth = 1;
+		stackNodes[0] = (u32)nIndex;
+		stackCursors[0] = TreeViewAt(allNodeRefs, nIndex).partitionStarts[outgoingPartition];
+		states[nIndex] = 1;
+		while (stackDepth > 0)
 		{
-			VarArrayLoopGet(TreeReference, reference, &node->references, rIndex);
-			if ((reference->isIncoming && includeIncoming) ||
-				(!reference->isIncoming && includeOutgoing))
+			u32 topIndex = stackNodes[stackDepth-1];
+			const TreeNodeRefs* nodeRefs = &TreeViewAt(allNodeRefs, topIndex);
+			if (stackCursors[stackDepth-1] < nodeRefs->partitionStarts[outgoingPartition+1])
 			{
-				if (foundIndex >= index)
+				const TreeReference* reference = &TreeViewAt(refs, stackCursors[stackDepth-1]);
+				stackCursors[stackDepth-1]++;
+				u32 childIndex = reference->nodeIndex;
+				if (childIndex == TREE_INVALID_INDEX || tiers[childIndex] != TREE_INVALID_TIER) { continue; } //nodes with a valid tier can't be part of a cycle
+				if (states[childIndex] == 1)
 				{
-					SetOptionalOutPntr(nodeOut, reference->node);
-					return reference->branch;
+					*VarArrayAdd(TreeBranchHandle, branchHandlesOut) = GetTreeBranchHandle(tree, &TreeViewAt(branches, reference->branchIndex));
+					result++;
 				}
-				foundIndex++;
-			}
-		}
-		return nullptr;
-	}
-	else
-	{
-		uxx foundIndex = 0;
-		VarArrayLoop(&tree->branches, bIndex)
-		{
-			VarArrayLoopGet(TreeBranch, branch, &tree->branches, bIndex);
-			if ((branch->toId == node->id && includeIncoming) ||
-				(branch->fromId == node->id && includeOutgoing))
-			{
-				if (foundIndex >= index)
+				else if (states[childIndex] == 0)
 				{
-					if (nodeOut != nullptr) { *nodeOut = GetTreeNodeById(tree, (branch->fromId == node->id) ? branch->toId : branch->fromId); }
-					return branch;
+					states[childIndex] = 1;
+					stackNodes[stackDepth] = childIndex;
+					stackCursors[stackDepth] = TreeViewAt(allNodeRefs, childIndex).partitionStarts[outgoingPartition];
+					stackDepth++;
 				}
-				foundIndex++;
+			}
+			else
+			{
+				states[topIndex] = 2;
+				stackDepth--;
 			}
 		}
-		return nullptr;
 	}
+	ScratchEnd(scratch);
+	return result;
 }
 
-void UnbakeTreeReferences(SkillTree* tree)
+// Returns a VarArray of u32 node indices where every node comes after all of its dependencies (sorted by tier, then by index).
+// It's rebuilt with a counting sort (O(N + number of tiers)) only when a tier changed since the last call
+const VarArray* GetTreeTopologicalOrder(SkillTree* tree)
 {
 	NotNull(tree);
-	NotNull(tree->arena);
 	Assert(tree->referencesBaked);
+	if (tree->tiersDirty) { RecalculateTreeTiers(tree); }
+	if (!tree->topoOrderDirty) { return &tree->topoOrder; }
 	
-	VarArrayLoop(&tree->nodes, nIndex)
+	const u32* tiers = (const u32*)tree->nodeTiers.items;
+	TreeIdView nodeIds = GetTreeNodeIdsView(tree);
+	u32 maxTier = 0;
+	for (uxx nIndex = 0; nIndex < nodeIds.count; nIndex++)
 	{
-		VarArrayLoopGet(TreeNode, node, &tree->nodes, nIndex);
-		FreeVarArray(&node->references);
+		if (TreeViewAt(nodeIds, nIndex) != 0 && tiers[nIndex] != TREE_INVALID_TIER && tiers[nIndex] > maxTier) { maxTier = tiers[nIndex]; }
 	}
-	VarArrayLoop(&tree->branches, bIndex)
+	
+	ScratchBegin1(scratch, tree->arena);
+	u32* tierStarts = AllocArray(u32, scratch, (uxx)maxTier + 2);
+	MyMemSet(tierStarts, 0x00, sizeof(u32) * ((uxx)maxTier + 2));
+	for (uxx nIndex = 0; nIndex < nodeIds.count; nIndex++)
 	{
-		VarArrayLoopGet(TreeBranch, branch, &tree->branches, bIndex);
-		branch->fromPntr = nullptr;
-		branch->toPntr = nullptr;
+		if (TreeViewAt(nodeIds, nIndex) != 0 && tiers[nIndex] != TREE_INVALID_TIER) { tierStarts[tiers[nIndex] + 1]++; }
 	}
+	for (uxx tIndex = 1; tIndex <= (uxx)maxTier + 1; tIndex++) { tierStarts[tIndex] += tierStarts[tIndex-1]; }
 	
-	tree->referencesBaked = false;
+	VarArrayClear(&tree->topoOrder, false);
+	if (tierStarts[maxTier + 1] > 0) { VarArrayAddMulti(u32, &tree->topoOrder, tierStarts[maxTier + 1]); }
+	u32* order = (u32*)tree->topoOrder.items;
+	for (uxx nIndex = 0; nIndex < nodeIds.count; nIndex++)
+	{
+		if (TreeViewAt(nodeIds, nIndex) != 0 && tiers[nIndex] != TREE_INVALID_TIER) { order[tierStarts[tiers[nIndex]]++] = (u32)nIndex; }
+	}
+	ScratchEnd(scratch);
+	tree->topoOrderDirty = false;
+	return &tree->topoOrder;
 }
-void BakeTreeReferences(SkillTree* tree)
+
+// +--------------------------------------------------------------+
+// |                          Stats Panel                         |
+// +--------------------------------------------------------------+
+// Everything here is read from counts the tree already keeps. The only work this can do is recalculating the tiers (if they're dirty)
+// or rebuilding the components (if a branch was removed since the last call), both O(N + B) and at most once per edit
+void GetTreeStats(SkillTree* tree, TreeStats* statsOut)
 {
 	NotNull(tree);
-	NotNull(tree->arena);
-	Assert(!tree->referencesBaked);
+	NotNull(statsOut);
+	Assert(tree->referencesBaked);
+	if (tree->tiersDirty) { RecalculateTreeTiers(tree); }
+	if (tree->componentsDirty) { RebuildTreeComponents(tree); }
+	// The highest tiers/degrees go away as nodes are removed, we trim them here rather than searching for the new maximum on every edit
+	while (tree->tierCounts.length > 0 && *VarArrayGetLast(uxx, &tree->tierCounts) == 0) { VarArrayRemoveAt(uxx, &tree->tierCounts, tree->tierCounts.length-1); }
+	while (tree->degreeCounts.length > 0 && *VarArrayGetLast(uxx, &tree->degreeCounts) == 0) { VarArrayRemoveAt(uxx, &tree->degreeCounts, tree->degreeCounts.length-1); }
+	
+	ClearPointer(statsOut);
+	statsOut->numNodes = tree->numNodes;
+	statsOut->numBranches = tree->numBranches;
+	MyMemCopy(&statsOut->numNodesByType[0], &tree->numNodesByType[0], sizeof(tree->numNodesByType));
+	MyMemCopy(&statsOut->numBranchesByType[0], &tree->numBranchesByType[0], sizeof(tree->numBranchesByType));
+	statsOut->numOrphanNodes = (tree->degreeCounts.length > 0) ? *VarArrayGetHard(uxx, &tree->degreeCounts, 0) : 0;
+	statsOut->numDanglingBranchEnds = tree->numDanglingBranchEnds;
+	statsOut->maxDegree = (tree->degreeCounts.length > 0) ? tree->degreeCounts.length-1 : 0;
+	statsOut->degreeCounts = (tree->degreeCounts.length > 0) ? (const uxx*)tree->degreeCounts.items : nullptr;
+	statsOut->longestChain = (tree->tierCounts.length > 0) ? tree->tierCounts.length-1 : 0;
+	statsOut->numCyclicNodes = tree->numCyclicNodes;
+	statsOut->numComponents = tree->numComponents;
+	statsOut->numLearnedNodes = tree->numLearnedNodes;
+	statsOut->numUnlockedNodes = tree->numUnlockedNodes;
+}
+
+// +--------------------------------------------------------------+
+// |                      Learning Progress                       |
+// +--------------------------------------------------------------+
+bool IsTreeNodeLearned(SkillTree* tree, const TreeNode* node)
+{
+	NotNull(tree);
+	NotNull(node);
+	return IsTreeBitSet(&tree->nodeLearnedBits, GetTreeNodeIndex(tree, node));
+}
+bool IsTreeNodeUnlocked(SkillTree* tree, const TreeNode* node)
+{
+	NotNull(tree);
+	NotNull(node);
+	Assert(tree->referencesBaked);
+	return (*VarArrayGetHard(u32, &tree->nodeUnmetDependencies, GetTreeNodeIndex(tree, node)) == 0);
+}
+
+// Only the counters of the node's direct dependents change, so this is O(number of dependents) no matter how big the tree is.
+// On an unbaked tree only the learned bit changes, BakeTreeReferences counts the unmet dependencies from the bits
+void SetTreeNodeLearned(SkillTree* tree, const TreeNode* node, bool learned)
+{
+	NotNull(tree);
+	NotNull(node);
+	Assert(IsTreeSlotGenerationAlive(node->generation));
+	uxx nodeIndex = GetTreeNodeIndex(tree, node);
+	if (IsTreeBitSet(&tree->nodeLearnedBits, nodeIndex) == learned) { return; }
+	SetTreeBit(&tree->nodeLearnedBits, nodeIndex, learned);
+	if (learned) { tree->numLearnedNodes++; } else { tree->numLearnedNodes--; }
+	if (!tree->referencesBaked) { return; }
 	
-	VarArrayLoop(&tree->nodes, nIndex)
+	if (!tree->componentsDirty)
+	{
+		TreeProgress* progress = VarArrayGetHard(TreeProgress, &tree->componentProgress, FindTreeComponent(tree, (u32)nodeIndex));
+		if (learned) { progress->numLearned++; } else { progress->numLearned--; }
+	}
+	const TreeNodeRefs* nodeRefs = GetTreeNodeRefs(tree, nodeIndex);
+	uxx partition = GetTreeRefPartition(false, TreeBranchType_Dependency);
+	TreeReferenceView refs = GetTreeReferencesView(tree);
+	for (uxx rIndex = nodeRefs->partitionStarts[partition]; rIndex < nodeRefs->partitionStarts[partition+1]; rIndex++)
 	{
-		VarArrayLoopGet(TreeNode, node, &tree->nodes, nIndex);
-		InitVarArray(TreeReference, &node->references, tree->arena);
+		u32 dependentIndex = TreeViewAt(refs, rIndex).nodeIndex;
+		if (dependentIndex != TREE_INVALID_INDEX) { AdjustTreeUnmetDependencies(tree, dependentIndex, !learned); }
 	}
+}
+
+// The progress of the connected component the node is in. Like GetTreeStats this has to rebuild the components if a branch was removed since they were last built
+TreeProgress GetTreeComponentProgress(SkillTree* tree, const TreeNode* node)
+{
+	NotNull(tree);
+	NotNull(node);
+	Assert(tree->referencesBaked);
+	if (tree->componentsDirty) { RebuildTreeComponents(tree); }
+	return *VarArrayGetHard(TreeProgress, &tree->componentProgress, FindTreeComponent(tree, (u32)GetTreeNodeIndex(tree, node)));
+}
+
+// +--------------------------------------------------------------+
+// |                         Name Search                          |
+// +--------------------------------------------------------------+
+// Fuzzy matches node names against the query (see TrigramIndex), fills resultsOut best match first and returns how many were found.
+// tree->nameIndex is kept up to date by AddTreeNode, RemoveTreeNode and SetTreeNodeName so this is cheap enough to call on every keystroke
+uxx SearchTreeNodes(SkillTree* tree, Str8 query, uxx maxResults, TreeSearchResult* resultsOut)
+{
+	NotNull(tree);
+	Assert(resultsOut != nullptr || maxResults == 0);
+	if (maxResults == 0) { return 0; }
+	ScratchBegin1(scratch, tree->arena);
 	
-	VarArrayLoop(&tree->branches, bIndex)
+	TrigramMatch* matches = AllocArray(TrigramMatch, scratch, maxResults);
+	NotNull(matches);
+	uxx numMatches = SearchTrigramIndex(&tree->nameIndex, query, maxResults, matches);
+	for (uxx mIndex = 0; mIndex < numMatches; mIndex++)
 	{
-		VarArrayLoopGet(TreeBranch, branch, &tree->branches, bIndex);
-		TreeNode* fromNode = GetTreeNodeById(tree, branch->fromId);
-		branch->fromPntr = fromNode;
-		TreeNode* toNode = GetTreeNodeById(tree, branch->toId);
-		branch->toPntr = toNode;
-		if (fromNode != nullptr)
-		{
-			TreeReference* outgoingReference = VarArrayAdd(TreeReference, &fromNode->references);
-			NotNull(outgoingReference);
-			ClearPointer(outgoingReference);
-			outgoingReference->isIncoming = false;
-			outgoingReference->branch = branch;
-			outgoingReference->node = toNode;
-		}
-		if (toNode != nullptr)
-		{
-			TreeReference* incomingReference = VarArrayAdd(TreeReference, &toNode->references);
-			NotNull(incomingReference);
-			ClearPointer(incomingReference);
-			incomingReference->isIncoming = true;
-			incomingReference->branch = branch;
-			incomingReference->node = fromNode;
-		}
+		TreeNode* node = VarArrayGetHard(TreeNode, &tree->nodes, matches[mIndex].itemIndex);
+		Assert(IsTreeSlotGenerationAlive(node->generation));
+		resultsOut[mIndex].node.index = matches[mIndex].itemIndex;
+		resultsOut[mIndex].node.generation = node->generation;
+		resultsOut[mIndex].score = matches[mIndex].score;
 	}
 	
-	tree->referencesBaked = true;
+	ScratchEnd(scratch);
+	return numMatches;
 }
 
+// +--------------------------------------------------------------+
+// |                       Add and Remove                         |
+// +--------------------------------------------------------------+
+// Removing a branch frees its slot for reuse. Nothing else moves so the only references we touch are the two at either end of the branch
 void RemoveTreeBranch(SkillTree* tree, TreeBranch* branch)
 {
 	NotNull(tree);
 	NotNull(branch);
-	Assert(!tree->referencesBaked);
-	uxx branchIndex = 0;
-	bool foundIndex = VarArrayGetIndexOf(TreeBranch, &tree->branches, branch, &branchIndex);
-	Assert(foundIndex);
+	Assert(IsTreeSlotGenerationAlive(branch->generation));
+	uxx branchIndex = GetTreeBranchIndex(tree, branch);
+	if (tree->referencesBaked)
+	{
+		if (!IsEmptyTreeNodeHandle(branch->fromHandle)) { RemoveTreeNodeReference(tree, branch->fromHandle.index, GetTreeRefPartition(false, branch->type), (u32)branchIndex); }
+		else { RemoveTreeDanglingEnd(tree, branchIndex, false, branch->fromId); }
+		if (!IsEmptyTreeNodeHandle(branch->toHandle)) { RemoveTreeNodeReference(tree, branch->toHandle.index, GetTreeRefPartition(true, branch->type), (u32)branchIndex); }
+		else { RemoveTreeDanglingEnd(tree, branchIndex, true, branch->toId); }
+		if (!IsEmptyTreeNodeHandle(branch->fromHandle) && !IsEmptyTreeNodeHandle(branch->toHandle))
+		{
+			if (branch->type == TreeBranchType_Dependency) { LowerTreeNodeTiers(tree, branch->toHandle.index); }
+			if (branch->fromHandle.index != branch->toHandle.index) { tree->componentsDirty = true; }
+		}
+	}
+	SetTreeBit(&tree->branchTypeBits[branch->type], branchIndex, false);
+	SetTreeBit(&tree->visibleBranchBits, branchIndex, false);
+	tree->numBranchesByType[branch->type]--;
 	FreeTreeBranch(tree, branch);
-	VarArrayRemoveAt(TreeBranch, &tree->branches, branchIndex);
+	branch->generation++;
+	MarkTreeBranchChanged(tree, branchIndex);
+	*VarArrayAdd(u32, &tree->freeBranchSlots) = (u32)branchIndex;
+	tree->numBranches--;
+	if (tree->referencesBaked) { CompactTreeReferencesIfNeeded(tree); }
 }
+// Removes every branch that has nodeId on either end. If the tree is baked this only visits the node's own references,
+// otherwise it's a single pass over the branches (removing a branch only frees its slot so it doesn't disturb the loop)
 void RemoveTreeBranchesForId(SkillTree* tree, uxx nodeId)
 {
 	NotNull(tree);
-	while (true)
+	TreeNode* node = GetTreeNodeById(tree, nodeId);
+	if (tree->referencesBaked && node != nullptr)
 	{
-		TreeBranch* branch = GetTreeBranchById(tree, nodeId, 0);
-		if (branch == nullptr) { break; }
-		RemoveTreeBranch(tree, branch);
+		ScratchBegin1(scratch, tree->arena);
+		TreeNodeRefs* nodeRefs = GetTreeNodeRefs(tree, GetTreeNodeIndex(tree, node));
+		uxx numRefs = nodeRefs->partitionStarts[TREE_REF_NUM_PARTITIONS] - nodeRefs->partitionStarts[0];
+		TreeBranchHandle* doomedBranches = (numRefs > 0) ? AllocArray(TreeBranchHandle, scratch, numRefs) : nullptr;
+		TreeReferenceView refs = GetTreeReferencesView(tree);
+		TreeBranchView branches = GetTreeBranchesView(tree);
+		for (uxx rIndex = 0; rIndex < numRefs; rIndex++)
+		{
+			u32 branchIndex = TreeViewAt(refs, nodeRefs->partitionStarts[0] + rIndex).branchIndex;
+			doomedBranches[rIndex].index = branchIndex;
+			doomedBranches[rIndex].generation = TreeViewAt(branches, branchIndex).generation;
+		}
+		// A branch from the node to itself shows up twice, the second time its handle won't resolve anymore
+		for (uxx bIndex = 0; bIndex < numRefs; bIndex++)
+		{
+			TreeBranch* branch = GetTreeBranchByHandle(tree, doomedBranches[bIndex]);
+			if (branch != nullptr) { RemoveTreeBranch(tree, branch); }
+		}
+		ScratchEnd(scratch);
+	}
+	else
+	{
+		TreeBranchView branches = GetTreeBranchesView(tree);
+		for (uxx bIndex = 0; bIndex < branches.count; bIndex++)
+		{
+			TreeBranch* branch = &TreeViewAt(branches, bIndex);
+			if (!IsTreeSlotGenerationAlive(branch->generation)) { continue; }
+			if (branch->fromId == nodeId || branch->toId == nodeId) { RemoveTreeBranch(tree, branch); }
+		}
 	}
 }
 
+// Removing a node frees its slot for reuse. If the tree is baked, any branches still attached to the node become dangling
 void RemoveTreeNode(SkillTree* tree, TreeNode* node)
 {
 	NotNull(tree);
 	NotNull(node);
-	Assert(!tree->referencesBaked);
-	uxx nodeIndex = 0;
-	bool foundIndex = VarArrayGetIndexOf(TreeNode, &tree->nodes, node, &nodeIndex);
-	Assert(foundIndex);
+	Assert(IsTreeSlotGenerationAlive(node->generation));
+	uxx nodeIndex = GetTreeNodeIndex(tree, node);
+	bool removedLookup = IdTableRemove(&tree->nodeLookup, node->id);
+	Assert(removedLookup);
+	
+	if (tree->referencesBaked)
+	{
+		TreeNodeRefs* nodeRefs = GetTreeNodeRefs(tree, nodeIndex);
+		// The Dependency graph only changes if the node was linked to something through one. Without that nobody
+		// can reach it (and nothing asks about a removed node) so anything cached from the graph is still good
+		for (uxx dIndex = 0; dIndex < 2; dIndex++)
+		{
+			uxx partition = GetTreeRefPartition(dIndex == 1, TreeBranchType_Dependency);
+			if (nodeRefs->partitionStarts[partition+1] > nodeRefs->partitionStarts[partition]) { tree->dependencyVersion++; break; }
+		}
+		uxx degree = GetTreeNodeRefsDegree(nodeRefs);
+		AdjustTreeStatCount(&tree->degreeCounts, degree, false);
+		u32 oldTier = *VarArrayGetHard(u32, &tree->nodeTiers, nodeIndex);
+		MoveTreeTierCount(tree, oldTier, TREE_INVALID_TIER);
+		// A node downstream of a cycle might not have any Dependencies of its own for the loop below to dirty the tiers, so it's uncounted here
+		if (!tree->tiersDirty && oldTier == TREE_INVALID_TIER) { Assert(tree->numCyclicNodes > 0); tree->numCyclicNodes--; }
+		// A node without branches is a set of its own (anything it was joined to through a branch that's gone already made us dirty)
+		if (degree > 0) { tree->componentsDirty = true; }
+		else if (!tree->componentsDirty) { tree->numComponents--; }
+		bool isLearned = IsTreeBitSet(&tree->nodeLearnedBits, nodeIndex);
+		if (*VarArrayGetHard(u32, &tree->nodeUnmetDependencies, nodeIndex) == 0) { tree->numUnlockedNodes--; }
+		TreeReferenceView refs = GetTreeReferencesView(tree);
+		TreeBranchView branches = GetTreeBranchesView(tree);
+		for (uxx pIndex = 0; pIndex < TREE_REF_NUM_PARTITIONS; pIndex++)
+		{
+			bool isIncoming = (pIndex >= TreeBranchType_Count);
+			for (uxx rIndex = nodeRefs->partitionStarts[pIndex]; rIndex < nodeRefs->partitionStarts[pIndex+1]; rIndex++)
+			{
+				TreeReference* reference = &TreeViewAt(refs, rIndex);
+				TreeBranch* branch = &TreeViewAt(branches, reference->branchIndex);
+				if (isIncoming) { branch->toHandle = TreeNodeHandle_Empty; } else { branch->fromHandle = TreeNodeHandle_Empty; }
+				MarkTreeBranchChanged(tree, reference->branchIndex);
+				AddTreeDanglingEnd(tree, reference->branchIndex, isIncoming, node->id);
+				if (reference->nodeIndex != TREE_INVALID_INDEX && reference->nodeIndex != nodeIndex)
+				{
+					TreeReference* otherReference = FindTreeNodeReference(tree, reference->nodeIndex, GetTreeRefPartition(!isIncoming, branch->type), reference->branchIndex);
+					NotNull(otherReference);
+					otherReference->nodeIndex = TREE_INVALID_INDEX;
+					StampTreeNodeRefsPage(tree, reference->nodeIndex);
+					if (!isIncoming && branch->type == TreeBranchType_Dependency)
+					{
+						LowerTreeNodeTiers(tree, reference->nodeIndex);
+						if (!isLearned) { AdjustTreeUnmetDependencies(tree, reference->nodeIndex, false); }
+					}
+				}
+			}
+		}
+		tree->numUsedReferences -= (nodeRefs->partitionStarts[TREE_REF_NUM_PARTITIONS] - nodeRefs->partitionStarts[0]);
+		ClearPointer(nodeRefs);
+		StampTreeNodeRefsPage(tree, nodeIndex);
+	}
+	
+	if (IsTreeBitSet(&tree->nodeLearnedBits, nodeIndex))
+	{
+		SetTreeBit(&tree->nodeLearnedBits, nodeIndex, false);
+		tree->numLearnedNodes--;
+	}
+	RemoveTrigramIndexItem(&tree->nameIndex, nodeIndex, GetTreeNodeName(tree, node));
+	SetTreeBit(&tree->nodeTypeBits[node->type], nodeIndex, false);
+	SetTreeBit(&tree->visibleNodeBits, nodeIndex, false);
+	tree->numNodesByType[node->type]--;
 	FreeTreeNode(tree, node);
-	VarArrayRemoveAt(TreeNode, &tree->nodes, nodeIndex);
+	node->generation++;
+	*VarArrayGetHard(uxx, &tree->nodeIds, nodeIndex) = 0;
+	MarkTreeNodeChanged(tree, nodeIndex);
+	*VarArrayAdd(u32, &tree->freeNodeSlots) = (u32)nodeIndex;
+	tree->numNodes--;
+	tree->nodesVersion++;
+	if (tree->referencesBaked) { CompactTreeReferencesIfNeeded(tree); }
 }
 void RemoveTreeNodeById(SkillTree* tree, uxx nodeId)
 {
@@ -228,34 +1681,345 @@ void RemoveTreeNodeById(SkillTree* tree, uxx nodeId)
 	RemoveTreeNode(tree, node);
 }
 
-TreeNode* AddTreeNode(SkillTree* tree, TreeNodeType type, Str8 name, v2 position, Color32 color)
+// Removes a whole selection of nodes along with every branch attached to them in O(N+B) (or O(sum of degrees) when baked).
+// Ids that don't exist (or show up more than once) are ignored
+void RemoveTreeNodesAndBranches(SkillTree* tree, uxx numNodeIds, const uxx* nodeIds)
+{
+	NotNull(tree);
+	Assert(nodeIds != nullptr || numNodeIds == 0);
+	if (numNodeIds == 0) { return; }
+	ScratchBegin1(scratch, tree->arena);
+	
+	u8* isDoomed = AllocArray(u8, scratch, tree->nodes.length);
+	NotNull(isDoomed);
+	MyMemSet(isDoomed, 0x00, sizeof(u8) * tree->nodes.length);
+	for (uxx iIndex = 0; iIndex < numNodeIds; iIndex++)
+	{
+		uxx nodeIndex = 0;
+		if (nodeIds[iIndex] != 0 && IdTableFind(&tree->nodeLookup, nodeIds[iIndex], &nodeIndex)) { isDoomed[nodeIndex] = 1; }
+	}
+	
+	if (tree->referencesBaked)
+	{
+		for (uxx iIndex = 0; iIndex < numNodeIds; iIndex++)
+		{
+			TreeNode* node = GetTreeNodeById(tree, nodeIds[iIndex]);
+			if (node != nullptr) { RemoveTreeBranchesForId(tree, node->id); }
+		}
+	}
+	else
+	{
+		TreeBranchView branches = GetTreeBranchesView(tree);
+		for (uxx bIndex = 0; bIndex < branches.count; bIndex++)
+		{
+			TreeBranch* branch = &TreeViewAt(branches, bIndex);
+			if (!IsTreeSlotGenerationAlive(branch->generation)) { continue; }
+			uxx fromIndex = 0, toIndex = 0;
+			bool isFromDoomed = (branch->fromId != 0 && IdTableFind(&tree->nodeLookup, branch->fromId, &fromIndex) && isDoomed[fromIndex]);
+			bool isToDoomed = (branch->toId != 0 && IdTableFind(&tree->nodeLookup, branch->toId, &toIndex) && isDoomed[toIndex]);
+			if (isFromDoomed || isToDoomed) { RemoveTreeBranch(tree, branch); }
+		}
+	}
+	
+	for (uxx iIndex = 0; iIndex < numNodeIds; iIndex++)
+	{
+		uxx nodeIndex = 0;
+		if (nodeIds[iIndex] == 0 || !IdTableFind(&tree->nodeLookup, nodeIds[iIndex], &nodeIndex)) { continue; }
+		Assert(isDoomed[nodeIndex]);
+		RemoveTreeNode(tree, VarArrayGetHard(TreeNode, &tree->nodes, nodeIndex));
+	}
+	
+	ScratchEnd(scratch);
+}
+
+// Most callers want AddTreeNode below. This version is for re-creating a node that used to exist (undo, loading files, etc.)
+// so the id is chosen by the caller and must not belong to any node that is currently in the tree
+TreeNode* AddTreeNodeWithId(SkillTree* tree, uxx nodeId, TreeNodeType type, u32 nameId, v2 position, Color32 color)
 {
 	NotNull(tree);
 	NotNull(tree->arena);
-	Assert(!tree->referencesBaked);
-	TreeNode* result = VarArrayAdd(TreeNode, &tree->nodes);
-	NotNull(result);
-	ClearPointer(result);
-	result->id = tree->nextNodeId;
-	tree->nextNodeId++;
+	Assert(nodeId != 0);
+	Assert(type < TreeNodeType_Count);
+	Assert(GetTreeNodeById(tree, nodeId) == nullptr);
+	Assert(nameId <= GetNumStrPoolStrs(&tree->names)); //id 0 (the empty string) isn't counted
+	tree->dependencyVersion++;
+	uxx resultIndex = 0;
+	if (tree->freeNodeSlots.length > 0)
+	{
+		resultIndex = *VarArrayGetLast(u32, &tree->freeNodeSlots);
+		VarArrayRemoveAt(u32, &tree->freeNodeSlots, tree->freeNodeSlots.length-1);
+	}
+	else
+	{
+		Assert(tree->nodes.length < TREE_INVALID_INDEX);
+		resultIndex = tree->nodes.length;
+		ClearPointer(VarArrayAdd(TreeNode, &tree->nodes));
+		VarArrayAdd(uxx, &tree->nodeIds);
+		VarArrayAdd(v2, &tree->nodePositions);
+		VarArrayAdd(Color32, &tree->nodeColors);
+		if (tree->referencesBaked)
+		{
+			VarArrayAdd(TreeNodeRefs, &tree->nodeRefs);
+			VarArrayAdd(u32, &tree->nodeTiers);
+			*VarArrayAdd(u32, &tree->cycleSearchMarks) = 0;
+			VarArrayAdd(u32, &tree->componentParents);
+			VarArrayAdd(u8, &tree->componentRanks);
+			VarArrayAdd(TreeProgress, &tree->componentProgress);
+			VarArrayAdd(u32, &tree->nodeUnmetDependencies);
+		}
+	}
+	
+	TreeNode* result = VarArrayGetHard(TreeNode, &tree->nodes, resultIndex);
+	Assert(!IsTreeSlotGenerationAlive(result->generation));
+	result->generation++;
+	result->id = nodeId;
+	if (tree->nextNodeId <= nodeId) { tree->nextNodeId = nodeId+1; }
 	result->type = type;
-	result->name = AllocStr8(tree->arena, name);
-	result->position = position;
-	result->color = color;
+	result->nameId = nameId;
+	*VarArrayGetHard(uxx, &tree->nodeIds, resultIndex) = result->id;
+	*VarArrayGetHard(v2, &tree->nodePositions, resultIndex) = position;
+	*VarArrayGetHard(Color32, &tree->nodeColors, resultIndex) = color;
+	MarkTreeNodeChanged(tree, resultIndex);
+	IdTableSet(&tree->nodeLookup, result->id, resultIndex);
+	AddTrigramIndexItem(&tree->nameIndex, resultIndex, GetStrPoolStr(&tree->names, nameId));
+	SetTreeBit(&tree->nodeTypeBits[type], resultIndex, true);
+	if (IsFlagSet(tree->visibleNodeTypes, TreeNodeTypeFlag(type))) { SetTreeBit(&tree->visibleNodeBits, resultIndex, true); }
+	tree->numNodes++;
+	tree->nodesVersion++;
+	tree->numNodesByType[type]++;
+	
+	if (tree->referencesBaked)
+	{
+		TreeNodeRefs* newNodeRefs = GetTreeNodeRefs(tree, resultIndex);
+		ClearPointer(newNodeRefs);
+		for (uxx pIndex = 0; pIndex <= TREE_REF_NUM_PARTITIONS; pIndex++) { newNodeRefs->partitionStarts[pIndex] = (u32)tree->references.length; }
+		StampTreeNodeRefsPage(tree, resultIndex);
+		*VarArrayGetHard(u32, &tree->nodeTiers, resultIndex) = 0;
+		MoveTreeTierCount(tree, TREE_INVALID_TIER, 0);
+		tree->topoOrderDirty = true;
+		AdjustTreeStatCount(&tree->degreeCounts, 0, true);
+		*VarArrayGetHard(u32, &tree->componentParents, resultIndex) = (u32)resultIndex;
+		*VarArrayGetHard(u8, &tree->componentRanks, resultIndex) = 0;
+		TreeProgress* newProgress = VarArrayGetHard(TreeProgress, &tree->componentProgress, resultIndex);
+		ClearPointer(newProgress);
+		newProgress->numNodes = 1;
+		newProgress->numUnlocked = 1;
+		*VarArrayGetHard(u32, &tree->nodeUnmetDependencies, resultIndex) = 0;
+		tree->numUnlockedNodes++;
+		if (!tree->componentsDirty) { tree->numComponents++; }
+		
+		// Branches that were added before this node existed might be looking for this id. Linking an end takes it
+		// out of the list, so we keep taking the head until nothing is waiting for this id anymore
+		TreeNodeHandle resultHandle = GetTreeNodeHandle(tree, result);
+		uxx endIndex = 0;
+		while (IdTableFind(&tree->danglingEndLookup, result->id, &endIndex))
+		{
+			uxx bIndex = endIndex / 2;
+			TreeBranch* branch = VarArrayGetHard(TreeBranch, &tree->branches, bIndex);
+			Assert(IsTreeSlotGenerationAlive(branch->generation));
+			bool isFrom = (IsEmptyTreeNodeHandle(branch->fromHandle) && branch->fromId == result->id);
+			bool isTo = (IsEmptyTreeNodeHandle(branch->toHandle) && branch->toId == result->id);
+			Assert(isFrom || isTo);
+			// A Dependency that would close a cycle once it's linked is removed, the same as if it had been refused by AddTreeBranch
+			if (branch->type == TreeBranchType_Dependency && tree->rejectDependencyCycles)
+			{
+				u32 fromIndex = isFrom ? (u32)resultIndex : (!IsEmptyTreeNodeHandle(branch->fromHandle) ? branch->fromHandle.index : TREE_INVALID_INDEX);
+				u32 toIndex = isTo ? (u32)resultIndex : (!IsEmptyTreeNodeHandle(branch->toHandle) ? branch->toHandle.index : TREE_INVALID_INDEX);
+				if (fromIndex != TREE_INVALID_INDEX && toIndex != TREE_INVALID_INDEX && WouldTreeDependencyCloseCycle(tree, fromIndex, toIndex))
+				{
+					RemoveTreeBranch(tree, branch);
+					tree->numRejectedDependencies++;
+					continue;
+				}
+			}
+			// Unlink whatever half of the branch was already linked, then link the whole thing again
+			if (!IsEmptyTreeNodeHandle(branch->fromHandle)) { RemoveTreeNodeReference(tree, branch->fromHandle.index, GetTreeRefPartition(false, branch->type), (u32)bIndex); }
+			if (!IsEmptyTreeNodeHandle(branch->toHandle)) { RemoveTreeNodeReference(tree, branch->toHandle.index, GetTreeRefPartition(true, branch->type), (u32)bIndex); }
+			if (isFrom) { branch->fromHandle = resultHandle; RemoveTreeDanglingEnd(tree, bIndex, false, result->id); }
+			if (isTo) { branch->toHandle = resultHandle; RemoveTreeDanglingEnd(tree, bIndex, true, result->id); }
+			MarkTreeBranchChanged(tree, bIndex);
+			LinkTreeBranchReferences(tree, bIndex);
+			if (branch->type == TreeBranchType_Dependency && !IsEmptyTreeNodeHandle(branch->fromHandle) && !IsEmptyTreeNodeHandle(branch->toHandle))
+			{
+				RaiseTreeNodeTiers(tree, branch->fromHandle.index, branch->toHandle.index);
+			}
+		}
+	}
 	return result;
 }
+TreeNode* AddTreeNode(SkillTree* tree, TreeNodeType type, Str8 name, v2 position, Color32 color)
+{
+	NotNull(tree);
+	return AddTreeNodeWithId(tree, tree->nextNodeId, type, InternStr(&tree->names, name), position, color);
+}
 
-TreeBranch* AddTreeBranch(SkillTree* tree, TreeBranchType type, Str8 name, uxx fromId, uxx toId)
+// Returns nullptr if the branch is a Dependency that would close a cycle (and tree->rejectDependencyCycles is set)
+TreeBranch* AddTreeBranchWithNameId(SkillTree* tree, TreeBranchType type, u32 nameId, uxx fromId, uxx toId)
 {
 	NotNull(tree);
 	NotNull(tree->arena);
-	Assert(!tree->referencesBaked);
-	TreeBranch* result = VarArrayAdd(TreeBranch, &tree->branches);
-	NotNull(result);
-	ClearPointer(result);
+	Assert(type < TreeBranchType_Count);
+	if (type == TreeBranchType_Dependency && tree->rejectDependencyCycles)
+	{
+		TreeNode* fromNode = tree->referencesBaked ? GetTreeNodeById(tree, fromId) : nullptr;
+		TreeNode* toNode = tree->referencesBaked ? GetTreeNodeById(tree, toId) : nullptr;
+		if (fromId == toId || (fromNode != nullptr && toNode != nullptr && WouldTreeDependencyCloseCycle(tree, (u32)GetTreeNodeIndex(tree, fromNode), (u32)GetTreeNodeIndex(tree, toNode))))
+		{
+			tree->numRejectedDependencies++;
+			return nullptr;
+		}
+	}
+	uxx resultIndex = 0;
+	if (tree->freeBranchSlots.length > 0)
+	{
+		resultIndex = *VarArrayGetLast(u32, &tree->freeBranchSlots);
+		VarArrayRemoveAt(u32, &tree->freeBranchSlots, tree->freeBranchSlots.length-1);
+	}
+	else
+	{
+		Assert(tree->branches.length < TREE_INVALID_INDEX);
+		resultIndex = tree->branches.length;
+		ClearPointer(VarArrayAdd(TreeBranch, &tree->branches));
+	}
+	
+	TreeBranch* result = VarArrayGetHard(TreeBranch, &tree->branches, resultIndex);
+	Assert(!IsTreeSlotGenerationAlive(result->generation));
+	result->generation++;
 	result->type = type;
-	result->name = AllocStr8(tree->arena, name);
+	result->nameId = nameId;
 	result->fromId = fromId;
 	result->toId = toId;
+	SetTreeBit(&tree->branchTypeBits[type], resultIndex, true);
+	MarkTreeBranchChanged(tree, resultIndex);
+	if (IsFlagSet(tree->visibleBranchTypes, TreeBranchTypeFlag(type))) { SetTreeBit(&tree->visibleBranchBits, resultIndex, true); }
+	tree->numBranches++;
+	tree->numBranchesByType[type]++;
+	if (tree->referencesBaked)
+	{
+		result->fromHandle = GetTreeNodeHandle(tree, GetTreeNodeById(tree, fromId));
+		result->toHandle = GetTreeNodeHandle(tree, GetTreeNodeById(tree, toId));
+		if (IsEmptyTreeNodeHandle(result->fromHandle)) { AddTreeDanglingEnd(tree, resultIndex, false, fromId); }
+		if (IsEmptyTreeNodeHandle(result->toHandle)) { AddTreeDanglingEnd(tree, resultIndex, true, toId); }
+		LinkTreeBranchReferences(tree, resultIndex);
+		if (type == TreeBranchType_Dependency && !IsEmptyTreeNodeHandle(result->fromHandle) && !IsEmptyTreeNodeHandle(result->toHandle))
+		{
+			RaiseTreeNodeTiers(tree, result->fromHandle.index, result->toHandle.index);
+		}
+	}
 	return result;
 }
+TreeBranch* AddTreeBranch(SkillTree* tree, TreeBranchType type, Str8 name, uxx fromId, uxx toId)
+{
+	NotNull(tree);
+	return AddTreeBranchWithNameId(tree, type, InternStr(&tree->names, name), fromId, toId);
+}
+
+// +--------------------------------------------------------------+
+// |                      Edit Transactions                       |
+// +--------------------------------------------------------------+
+// Use these around large batches of edits (imports, scripts, etc.). The expected counts are used to reserve capacity for
+// every node/branch array up front, and if the batch is big compared to the tree we unbake the references now and bake them
+// once in CommitTreeEdit rather than updating them incrementally for every edit. Small batches keep incremental updates.
+// Node removals queued with QueueTreeNodeRemoval are deferred to the commit so they can all be done in one O(N+B) pass.
+void BeginTreeEdit(SkillTree* tree, uxx numNodesToAdd, uxx numBranchesToAdd)
+{
+	NotNull(tree);
+	NotNull(tree->arena);
+	Assert(!tree->isEditing);
+	tree->isEditing = true;
+	tree->rebakeOnCommit = false;
+	VarArrayClear(&tree->pendingNodeRemovals, false);
+	
+	if (tree->referencesBaked && (numNodesToAdd + numBranchesToAdd) * TREE_EDIT_REBAKE_DIVISOR > (tree->numNodes + tree->numBranches))
+	{
+		UnbakeTreeReferences(tree);
+		tree->rebakeOnCommit = true;
+	}
+	
+	// Every array indexed by node or branch slot is reserved below, any new one has to be added here too:
+	//   by node slot:   nodes, nodeIds, nodePositions, nodeColors, nameIndex's item arrays, nodeTypeBits, visibleNodeBits, nodeLearnedBits,
+	//                   nodeHashEntries, nodePageVersions and nodeRefPageVersions (one per page), and the baked ones: nodeRefs, nodeTiers,
+	//                   cycleSearchMarks, componentParents, componentRanks, componentProgress, nodeUnmetDependencies
+	//   by branch slot: branches, branchTypeBits, visibleBranchBits, branchHashEntries, branchPageVersions (one per page), danglingEnds (two per slot)
+	// references, degreeCounts and tierCounts aren't indexed by slot, and nodeLookup is reserved by node count
+	uxx numNewNodeSlots = (numNodesToAdd > tree->freeNodeSlots.length) ? (numNodesToAdd - tree->freeNodeSlots.length) : 0;
+	uxx numNewBranchSlots = (numBranchesToAdd > tree->freeBranchSlots.length) ? (numBranchesToAdd - tree->freeBranchSlots.length) : 0;
+	if (numNewNodeSlots > 0)
+	{
+		uxx numNodeSlots = tree->nodes.length + numNewNodeSlots;
+		uxx numNodePages = (numNodeSlots + TREE_SNAPSHOT_PAGE_SIZE-1) / TREE_SNAPSHOT_PAGE_SIZE;
+		VarArrayExpand(&tree->nodes, numNodeSlots);
+		VarArrayExpand(&tree->nodeIds, numNodeSlots);
+		VarArrayExpand(&tree->nodePositions, numNodeSlots);
+		VarArrayExpand(&tree->nodeColors, numNodeSlots);
+		ReserveTrigramIndexItems(&tree->nameIndex, numNodeSlots);
+		for (uxx tIndex = 0; tIndex < TreeNodeType_Count; tIndex++) { ReserveTreeBits(&tree->nodeTypeBits[tIndex], numNodeSlots); }
+		ReserveTreeBits(&tree->visibleNodeBits, numNodeSlots);
+		ReserveTreeBits(&tree->nodeLearnedBits, numNodeSlots);
+		VarArrayExpand(&tree->nodePageVersions, numNodePages);
+		VarArrayExpand(&tree->nodeRefPageVersions, numNodePages);
+		VarArrayExpand(&tree->nodeHashEntries, numNodeSlots);
+		// If we just unbaked, these are refilled by the bake in CommitTreeEdit (unbaking keeps their buffers)
+		if (tree->referencesBaked || tree->rebakeOnCommit)
+		{
+			VarArrayExpand(&tree->nodeRefs, numNodeSlots);
+			VarArrayExpand(&tree->nodeTiers, numNodeSlots);
+			VarArrayExpand(&tree->cycleSearchMarks, numNodeSlots);
+			VarArrayExpand(&tree->componentParents, numNodeSlots);
+			VarArrayExpand(&tree->componentRanks, numNodeSlots);
+			VarArrayExpand(&tree->componentProgress, numNodeSlots);
+			VarArrayExpand(&tree->nodeUnmetDependencies, numNodeSlots);
+		}
+	}
+	if (numNewBranchSlots > 0)
+	{
+		uxx numBranchSlots = tree->branches.length + numNewBranchSlots;
+		VarArrayExpand(&tree->branches, numBranchSlots);
+		for (uxx tIndex = 0; tIndex < TreeBranchType_Count; tIndex++) { ReserveTreeBits(&tree->branchTypeBits[tIndex], numBranchSlots); }
+		ReserveTreeBits(&tree->visibleBranchBits, numBranchSlots);
+		VarArrayExpand(&tree->branchPageVersions, (numBranchSlots + TREE_SNAPSHOT_PAGE_SIZE-1) / TREE_SNAPSHOT_PAGE_SIZE);
+		VarArrayExpand(&tree->branchHashEntries, numBranchSlots);
+		VarArrayExpand(&tree->danglingEnds, numBranchSlots*2);
+	}
+	IdTableReserve(&tree->nodeLookup, tree->numNodes + numNodesToAdd);
+}
+
+// Outside of an edit transaction this removes the node (and its branches) immediately
+void QueueTreeNodeRemoval(SkillTree* tree, uxx nodeId)
+{
+	NotNull(tree);
+	if (tree->isEditing) { *VarArrayAdd(uxx, &tree->pendingNodeRemovals) = nodeId; }
+	else { RemoveTreeNodesAndBranches(tree, 1, &nodeId); }
+}
+
+void CommitTreeEdit(SkillTree* tree)
+{
+	NotNull(tree);
+	Assert(tree->isEditing);
+	if (tree->pendingNodeRemovals.length > 0)
+	{
+		RemoveTreeNodesAndBranches(tree, tree->pendingNodeRemovals.length, (const uxx*)tree->pendingNodeRemovals.items);
+		VarArrayClear(&tree->pendingNodeRemovals, false);
+	}
+	if (tree->rebakeOnCommit)
+	{
+		BakeTreeReferences(tree);
+		tree->rebakeOnCommit = false;
+		// Nothing was checking for cycles while we were unbaked, so the Dependencies that close them are rejected now instead
+		if (tree->rejectDependencyCycles)
+		{
+			ScratchBegin1(scratch, tree->arena);
+			VarArray cycleBranches;
+			InitVarArray(TreeBranchHandle, &cycleBranches, scratch);
+			FindTreeDependencyCycleBranches(tree, &cycleBranches);
+			VarArrayLoop(&cycleBranches, cIndex)
+			{
+				VarArrayLoopGet(TreeBranchHandle, branchHandle, &cycleBranches, cIndex);
+				RemoveTreeBranch(tree, GetTreeBranchByHandle(tree, *branchHandle));
+				tree->numRejectedDependencies++;
+			}
+			ScratchEnd(scratch);
+		}
+	}
+	tree->isEditing = false;
+}
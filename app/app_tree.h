@@ -51,30 +51,120 @@ const char* GetTreeBranchTypeStr(TreeBranchType enumValue)
 	}
 }
 
+// Flags for filtering references by TreeBranchType (bit index is the enum value)
+#define TreeBranchTypeFlag(branchType) (u8)(1 << (branchType))
+#define TreeBranchTypeFlags_All        (u8)((1 << TreeBranchType_Count) - 1)
+// Same thing for TreeNodeType (used for visibility, see SetTreeVisibleTypes)
+#define TreeNodeTypeFlag(nodeType)     (u8)(1 << (nodeType))
+#define TreeNodeTypeFlags_All          (u8)((1 << TreeNodeType_Count) - 1)
+
+// Walks the set bits in a VarArray of u64 words (like tree->visibleNodeBits) a whole word at a time,
+// so a long run of hidden/free slots costs one compare per 64 slots. Usage:
+// TreeBitsLoop(&tree->visibleNodeBits, nIndex) { ... }
+#define TreeBitsLoop(bitsPntr, indexName) for (uxx indexName = FindNextTreeBit((bitsPntr), 0); indexName < (bitsPntr)->length * 64; indexName = FindNextTreeBit((bitsPntr), indexName+1))
+
+// Baked references for each node are partitioned first by direction (all outgoing before all incoming) and then by TreeBranchType
+#define TREE_REF_NUM_PARTITIONS  (2 * TreeBranchType_Count)
+#define GetTreeRefPartition(isIncoming, branchType) (((isIncoming) ? TreeBranchType_Count : 0) + (uxx)(branchType))
+// Address space reserved for each SkillTree's arena, pages are only committed as the tree actually uses them
+#define TREE_ARENA_MAX_SIZE  Gigabytes(1)
+// Node and branch slots are grouped into pages of this many slots for change tracking. A TreeSnapshot copies
+// whole pages, so this trades the size of the snapshot page tables against how much one edit makes us copy
+#define TREE_SNAPSHOT_PAGE_SIZE  256
+// Nodes and branches are spread over this many buckets for content hashing (see GetTreeRootHash)
+#define TREE_HASH_BUCKET_BITS    8
+#define TREE_HASH_NUM_BUCKETS    (1 << TREE_HASH_BUCKET_BITS)
+#define TREE_HASH_NODE_TAG       0x45444F4E //"NODE", keeps a node and a branch from ever hashing the same input
+#define TREE_HASH_BRANCH_TAG     0x48435242 //"BRCH"
+
+#define TREE_INVALID_INDEX  UINT32_MAX
+#define TREE_INVALID_TIER   UINT32_MAX
+
+// Handles stay valid across edits because node and branch slots never move, they are only freed and reused.
+// Every time a slot is allocated or freed its generation is incremented, so a slot is alive while its generation
+// is odd and a handle to a removed node (or branch) resolves to nullptr rather than whatever lives in that slot now.
+// The zeroed handle (generation 0) never resolves to anything.
+typedef struct TreeNodeHandle TreeNodeHandle;
+struct TreeNodeHandle
+{
+	u32 index;
+	u32 generation;
+};
+typedef struct TreeBranchHandle TreeBranchHandle;
+struct TreeBranchHandle
+{
+	u32 index;
+	u32 generation;
+};
+#define TreeNodeHandle_Empty    ((TreeNodeHandle){ .index=0, .generation=0 })
+#define TreeBranchHandle_Empty  ((TreeBranchHandle){ .index=0, .generation=0 })
+#define IsEmptyTreeNodeHandle(handle)    ((handle).generation == 0)
+#define IsEmptyTreeBranchHandle(handle)  ((handle).generation == 0)
+#define AreEqualTreeNodeHandles(left, right)    ((left).index == (right).index && (left).generation == (right).generation)
+#define AreEqualTreeBranchHandles(left, right)  ((left).index == (right).index && (left).generation == (right).generation)
+#define IsTreeSlotGenerationAlive(generation)  (((generation) & 1) != 0)
+
 typedef struct TreeReference TreeReference;
 struct TreeReference
 {
-	bool isIncoming; //if true, we should be the branch->toId, otherwise we should be the branch->fromId
-	struct TreeBranch* branch;
-	struct TreeNode* node;
+	u32 branchIndex; //index into tree->branches
+	u32 nodeIndex; //index into tree->nodes for the node on the other end of the branch (TREE_INVALID_INDEX if that node doesn't exist)
+};
+
+// Each node owns one contiguous block of tree->references with some spare capacity at the end.
+// When the block fills up it gets moved to the end of the array (with double the capacity) and
+// the old block becomes a hole that is reclaimed the next time CompactTreeReferences runs
+typedef struct TreeNodeRefs TreeNodeRefs;
+struct TreeNodeRefs
+{
+	u32 capacity;
+	u32 partitionStarts[TREE_REF_NUM_PARTITIONS + 1]; //indices into tree->references, the last entry marks the end of the used references
+};
+
+// Two per branch slot (one for each end). Links a dangling end into the list of ends that are waiting for the same missing node id
+typedef struct TreeDanglingEnd TreeDanglingEnd;
+struct TreeDanglingEnd
+{
+	u32 prev; //index of the previous end waiting for the same id (TREE_INVALID_INDEX at the head)
+	u32 next;
+};
+
+// Learning progress over some set of nodes (the whole tree, or one connected component)
+typedef struct TreeProgress TreeProgress;
+struct TreeProgress
+{
+	uxx numNodes;
+	uxx numLearned;
+	uxx numUnlocked; //nodes whose dependencies are all learned (learned or not themselves)
+};
+
+// One per node/branch slot, links the element into the list of elements in its hash bucket
+typedef struct TreeHashEntry TreeHashEntry;
+struct TreeHashEntry
+{
+	u64 hash; //0 for free slots
+	u32 bucket; //TREE_INVALID_INDEX for free slots
+	u32 prev; //slot index of the previous element in the same bucket (TREE_INVALID_INDEX at the head)
+	u32 next;
 };
 
+// This is the "cold" part of a node. The data we touch every frame (id, position, color)
+// lives in parallel arrays in SkillTree (see nodeIds, nodePositions, nodeColors)
 typedef struct TreeNode TreeNode;
 struct TreeNode
 {
-	uxx id;
+	uxx id; //same as nodeIds[index], kept here so a TreeNode* is enough to identify the node
+	u32 generation;
 	TreeNodeType type;
-	Str8 name;
-	v2 position;
-	Color32 color;
-	VarArray references; //TreeReference (only filled if tree->referencesBaked)
+	u32 nameId; //into tree->names
 };
 
 typedef struct TreeBranch TreeBranch;
 struct TreeBranch
 {
+	u32 generation;
 	TreeBranchType type;
-	Str8 name;
+	u32 nameId; //into tree->names
 	union
 	{
 		struct { uxx fromId; uxx toId; };
@@ -84,22 +174,206 @@ struct TreeBranch
 	};
 	union
 	{
-		// These are only filled if tree->referencesBaked
-		struct { TreeNode* fromPntr; TreeNode* toPntr; };
-		struct { TreeNode* leftPntr; TreeNode* rightPntr; };
-		struct { TreeNode* firstPntr; TreeNode* secondPntr; };
-		struct { TreeNode* dependencyPntr; TreeNode* dependentPntr; };
+		// These are only filled if tree->referencesBaked (empty if there is no node with that id)
+		struct { TreeNodeHandle fromHandle; TreeNodeHandle toHandle; };
+		struct { TreeNodeHandle leftHandle; TreeNodeHandle rightHandle; };
+		struct { TreeNodeHandle firstHandle; TreeNodeHandle secondHandle; };
+		struct { TreeNodeHandle dependencyHandle; TreeNodeHandle dependentHandle; };
 	};
 };
 
 typedef struct SkillTree SkillTree;
 struct SkillTree
 {
+	// Everything the tree allocates (names, adjacency, element arrays, indices) comes out of its own StackVirtual arena,
+	// so freeing or reloading a tree releases one reservation instead of walking every node and branch.
+	// The arena never takes memory back before that, so edits don't free and reallocate: removed nodes and branches leave slots behind
+	// for reuse, and baking, unbaking and compacting refill the buffers the arrays already have. The only thing left behind is the old
+	// buffer when an array outgrows its capacity, which adds up to less than the array itself (see GetSkillTreeBytesUsed)
+	Arena* sourceArena; //the Arena struct for arena is allocated from here
 	Arena* arena;
 	uxx nextNodeId;
 	bool referencesBaked;
+	StrPool names; //all node and branch names are interned here
+	TrigramIndex nameIndex; //node names, item indices are node indices (see SearchTreeNodes)
+	// Nodes are stored as a structure of arrays, all indexed by the same node index.
+	// The per-frame loops only need to stream through the hot arrays (ids, positions, colors).
+	// Removed nodes leave a free slot behind (with an id of 0) that the next AddTreeNode will reuse
+	uxx numNodes;
+	VarArray freeNodeSlots; //u32
 	VarArray nodes; //TreeNode
-	VarArray branches; //TreeBranch
+	VarArray nodeIds; //uxx (0 for free slots)
+	VarArray nodePositions; //v2
+	VarArray nodeColors; //Color32
+	IdTable nodeLookup; //TreeNode::id -> node index
+	uxx numBranches;
+	VarArray freeBranchSlots; //u32
+	VarArray branches; //TreeBranch (slots with an even generation are free)
+	
+	// One bit per node/branch slot for each type (free slots have no bits set). The visible sets are the union of the
+	// type sets that are turned on in visibleNodeTypes/visibleBranchTypes. They are updated when an element is added
+	// or removed and rebuilt a word at a time when the flags change, so hiding a type costs nothing per frame
+	VarArray nodeTypeBits[TreeNodeType_Count]; //u64
+	VarArray branchTypeBits[TreeBranchType_Count]; //u64
+	u8 visibleNodeTypes; //TreeNodeTypeFlags
+	u8 visibleBranchTypes; //TreeBranchTypeFlags
+	VarArray visibleNodeBits; //u64
+	VarArray visibleBranchBits; //u64
+	
+	// These are only filled if referencesBaked. BakeTreeReferences packs them tightly (compressed-sparse-row style)
+	// and after that Add/Remove functions keep them up to date incrementally, only touching the nodes at each end of a branch
+	VarArray nodeRefs; //TreeNodeRefs (indexed by node index like nodes)
+	VarArray references; //TreeReference
+	uxx numUsedReferences; //references.length minus this is the number of slots sitting in holes or spare capacity
+	uxx numDanglingBranchEnds; //number of fromHandle/toHandle that are empty because there is no node with that id
+	// Dangling ends are kept in one list per missing id so adding a node only has to visit the branches that were waiting for it
+	IdTable danglingEndLookup; //missing node id -> index of the first end in danglingEnds
+	VarArray danglingEnds; //TreeDanglingEnd (branchIndex*2 for the from end, branchIndex*2 + 1 for the to end)
+	// Every change to what a node's references point at (a branch linked/unlinked at either end, the node at the other end removed,
+	// baking/unbaking) increments refsVersion and stamps the page of TREE_SNAPSHOT_PAGE_SIZE node slots it happened in. Anything that
+	// caches something per node derived from its references (like TreeSimilarIndex) only has to revisit the pages stamped since it last looked
+	u64 refsVersion;
+	VarArray nodeRefPageVersions; //u64 (the refsVersion of the last change in that page)
+	// Incremented whenever a node is added or removed. A branch only changes the graph when one of its ends is linked/unlinked, which
+	// refsVersion covers, so GetTreeStructureVersion (the two added up) changes with the graph but not when nodes are moved, renamed or recolored
+	u64 nodesVersion;
+	
+	// Dependency tiers are also only filled if referencesBaked. A node's tier is the length of the longest chain of Dependency
+	// branches leading into it (0 for nodes with no dependencies) so every dependency has a lower tier than its dependents.
+	// Adding/removing a Dependency raises/lowers the tiers downstream of that branch, anything that can't be handled
+	// incrementally (like a cycle) marks them dirty and they are recalculated in full the next time someone asks for them
+	VarArray nodeTiers; //u32 (indexed by node index like nodes)
+	bool tiersDirty;
+	uxx numCyclicNodes; //nodes that are in (or downstream of) a Dependency cycle, these have a tier of TREE_INVALID_TIER
+	bool topoOrderDirty;
+	VarArray topoOrder; //u32 (node indices sorted by tier, cyclic nodes are left out)
+	// Incremented whenever a node is added, a node with Dependencies is removed, a Dependency is linked/unlinked, or the references are baked.
+	// Anything that caches information derived from the Dependency graph (like TreeReachIndex) compares against this
+	u64 dependencyVersion;
+	// While this is set (the default) AddTreeBranch refuses any Dependency that would close a cycle in a baked tree, and a Dependency
+	// that was waiting for a missing node is removed instead of linked if it would close one once that node is added. Cycles can
+	// still show up through Dependencies added while unbaked outside of an edit transaction (see numCyclicNodes)
+	bool rejectDependencyCycles;
+	uxx numRejectedDependencies;
+	VarArray cycleSearchMarks; //u32 (indexed by node index, compared against cycleSearchStamp so it never needs clearing)
+	u32 cycleSearchStamp;
+	
+	// Everything the stats panel shows is kept up to date by the same Add/Remove functions, so GetTreeStats never has to walk the tree.
+	// The per-type counts are always valid, the rest are only filled if referencesBaked. degreeCounts follows every node's reference block
+	// as it grows and shrinks, and tierCounts follows the incremental tier updates above so the longest chain is only recalculated for the
+	// nodes a Dependency edit actually touches. Connected components are a union-find forest over the branches that have both ends linked.
+	// Union-find can't split a set, so removing a branch (or a node that still has branches) marks componentsDirty instead and the forest is
+	// rebuilt in O(N + B) the next time someone asks, which is once per edit at most rather than once per frame
+	uxx numNodesByType[TreeNodeType_Count];
+	uxx numBranchesByType[TreeBranchType_Count];
+	VarArray degreeCounts; //uxx (number of live nodes with each degree, a node's degree is the number of references in its block)
+	VarArray tierCounts; //uxx (number of live nodes in each tier, only valid while !tiersDirty)
+	VarArray componentParents; //u32 (indexed by node index like nodes)
+	VarArray componentRanks; //u8 (indexed by node index like nodes)
+	bool componentsDirty;
+	uxx numComponents; //only valid while !componentsDirty
+	
+	// A node is unlocked once every node it has a Dependency on (that exists) is learned. Rather than walking a node's dependencies
+	// to find out, each node counts the ones that aren't learned yet, so learning or unlearning a node only touches its dependents
+	// and linking/unlinking a Dependency only touches one counter. Each component's progress is kept at its root in componentProgress
+	// and merged by UnionTreeComponents (or rebuilt with the rest of the forest). Learned bits survive unbaking, the rest is only filled if referencesBaked
+	VarArray nodeLearnedBits; //u64 (by node index)
+	uxx numLearnedNodes;
+	VarArray nodeUnmetDependencies; //u32 (by node index, number of linked Dependency parents that aren't learned)
+	uxx numUnlockedNodes;
+	VarArray componentProgress; //TreeProgress (by node index, only means something at the root of a set while !componentsDirty)
+	
+	// Every change that a TreeSnapshot would see (adding/removing/renaming/moving/recoloring nodes, adding/removing branches,
+	// linking branch handles) increments snapshotVersion and stamps the page it happened in, so PublishTreeSnapshot only copies
+	// the pages that changed since the last snapshot. Writes made directly through a view (TreeViewAt) are not tracked
+	u64 snapshotVersion;
+	VarArray nodePageVersions; //u64 (one per TREE_SNAPSHOT_PAGE_SIZE node slots, the snapshotVersion of the last change in that page)
+	VarArray branchPageVersions; //u64 (same for branch slots)
+	
+	// The same changes also re-hash the element. Each live node and branch has a hash of its contents (not its slot index), and they
+	// are spread over TREE_HASH_NUM_BUCKETS buckets by identity (the node id, or the ends and type of a branch). A bucket's hash is the
+	// wrapping sum of its elements' hashes, so an edit updates it in O(1) regardless of order, and the root hash is a hash of all the
+	// bucket hashes. Comparing two trees only has to look inside the buckets whose hashes differ (see DiffSkillTrees)
+	VarArray nodeHashEntries; //TreeHashEntry (indexed by node index)
+	VarArray branchHashEntries; //TreeHashEntry (indexed by branch index)
+	u32 nodeHashHeads[TREE_HASH_NUM_BUCKETS]; //first node index in each bucket
+	u32 branchHashHeads[TREE_HASH_NUM_BUCKETS]; //first branch index in each bucket
+	u64 bucketHashes[TREE_HASH_NUM_BUCKETS]; //nodes and branches both add to these
+	bool rootHashDirty;
+	u64 rootHash; //only valid when !rootHashDirty, see GetTreeRootHash
+	
+	// Only used between BeginTreeEdit and CommitTreeEdit
+	bool isEditing;
+	bool rebakeOnCommit;
+	VarArray pendingNodeRemovals; //uxx (node ids)
+};
+
+// A copy of the numbers in the stats panel, see GetTreeStats
+typedef struct TreeStats TreeStats;
+struct TreeStats
+{
+	uxx numNodes;
+	uxx numBranches;
+	uxx numNodesByType[TreeNodeType_Count];
+	uxx numBranchesByType[TreeBranchType_Count];
+	uxx numOrphanNodes; //nodes without any branches
+	uxx numDanglingBranchEnds; //branch ends that don't have a node with that id (see SkillTree::numDanglingBranchEnds)
+	uxx maxDegree;
+	const uxx* degreeCounts; //[0, maxDegree], points into the tree so it's only good until the next edit
+	uxx longestChain; //number of Dependency branches in the longest chain, nodes in (or downstream of) a cycle are left out
+	uxx numCyclicNodes; //nodes in (or downstream of) a Dependency cycle, see SkillTree::numCyclicNodes
+	uxx numComponents; //sets of nodes connected by branches of any type, a node without branches is a component by itself
+	uxx numLearnedNodes;
+	uxx numUnlockedNodes;
+};
+
+typedef struct TreeSearchResult TreeSearchResult;
+struct TreeSearchResult
+{
+	TreeNodeHandle node;
+	r32 score; //1.0 is a perfect match
+};
+
+// Typed views over the tree's VarArrays. A view is just the items pointer and count, so indexing one with TreeViewAt is a plain
+// pointer offset that the compiler can inline and vectorize (the bounds check only exists in DEBUG_BUILD), unlike VarArrayGetHard
+// which checks the item size and bounds on every access. A view is only good until its VarArray is resized (adding nodes or branches,
+// baking, compacting the references, etc.) so take them right before the loop that uses them
+#define TREE_VIEW_TYPE(viewName, itemType) typedef struct viewName viewName; struct viewName { itemType* items; uxx count; }
+TREE_VIEW_TYPE(TreeNodeView, TreeNode);
+TREE_VIEW_TYPE(TreeBranchView, TreeBranch);
+TREE_VIEW_TYPE(TreeIdView, uxx);
+TREE_VIEW_TYPE(TreePositionView, v2);
+TREE_VIEW_TYPE(TreeColorView, Color32);
+TREE_VIEW_TYPE(TreeNodeRefsView, TreeNodeRefs);
+TREE_VIEW_TYPE(TreeReferenceView, TreeReference);
+TREE_VIEW_TYPE(TreeU32View, u32);
+
+#if DEBUG_BUILD
+#define NewTreeView(viewType, itemType, varArrayPntr) ((viewType){ .items = (itemType*)CheckTreeViewArray((varArrayPntr), sizeof(itemType)), .count = (varArrayPntr)->length })
+#define TreeViewAt(view, index) ((view).items[CheckTreeViewIndex((index), (view).count)])
+#else
+#define NewTreeView(viewType, itemType, varArrayPntr) ((viewType){ .items = (itemType*)(varArrayPntr)->items, .count = (varArrayPntr)->length })
+#define TreeViewAt(view, index) ((view).items[index])
+#endif
+
+// Walks the baked references of a single node. Usage:
+// TreeRefIter iter = NewTreeRefIter(tree, node, true, true, TreeBranchTypeFlags_All);
+// while (TreeRefIterStep(&iter)) { ...iter.branch, iter.node... }
+typedef struct TreeRefIter TreeRefIter;
+struct TreeRefIter
+{
+	SkillTree* tree;
+	uxx nodeIndex;
+	u32 partitionFlags; //bit per partition that we should visit
+	uxx partition;
+	uxx refIndex;
+	uxx index; //number of references stepped over so far
+	// These are filled by each successful TreeRefIterStep
+	bool isIncoming;
+	TreeBranchType branchType;
+	TreeReference* reference;
+	TreeBranch* branch;
+	TreeNode* node; //nullptr if the branch points to a node that doesn't exist
 };
 
 #endif //  _APP_TREE_H
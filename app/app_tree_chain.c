@@ -0,0 +1,180 @@
+/*
+File:   app_tree_chain.c
+Author: Taylor Robbins
+Date:   10\17\2026
+Description:
+	** Holds the TreeChainCache which finds (and remembers) everything upstream and
+	** downstream of a node along Dependency branches so it can be highlighted
+*/
+
+void FreeTreeChainCache(TreeChainCache* cache)
+{
+	NotNull(cache);
+	if (cache->arena != nullptr)
+	{
+		for (uxx eIndex = 0; eIndex < TREE_CHAIN_CACHE_SIZE; eIndex++)
+		{
+			TreeChainEntry* entry = &cache->entries[eIndex];
+			FreeVarArray(&entry->upstreamNodes);
+			FreeVarArray(&entry->downstreamNodes);
+			FreeVarArray(&entry->branchBits);
+		}
+		FreeVarArray(&cache->upstreamMarks);
+		FreeVarArray(&cache->downstreamMarks);
+	}
+	ClearPointer(cache);
+}
+
+// The reach index is shared with whoever else asks about prerequisites, the cache only reads it
+void InitTreeChainCache(Arena* arena, TreeReachIndex* reach, TreeChainCache* cacheOut)
+{
+	NotNull(arena);
+	NotNull(reach);
+	NotNull(cacheOut);
+	ClearPointer(cacheOut);
+	cacheOut->arena = arena;
+	cacheOut->reach = reach;
+	for (uxx eIndex = 0; eIndex < TREE_CHAIN_CACHE_SIZE; eIndex++)
+	{
+		TreeChainEntry* entry = &cacheOut->entries[eIndex];
+		entry->node = TreeNodeHandle_Empty;
+		InitVarArray(u32, &entry->upstreamNodes, arena);
+		InitVarArray(u32, &entry->downstreamNodes, arena);
+		InitVarArray(u64, &entry->branchBits, arena);
+	}
+	cacheOut->shownEntry = TREE_INVALID_INDEX;
+	InitVarArray(u32, &cacheOut->upstreamMarks, arena);
+	InitVarArray(u32, &cacheOut->downstreamMarks, arena);
+}
+
+bool IsTreeBranchOnChain(const TreeChainCache* cache, uxx branchIndex)
+{
+	NotNull(cache);
+	if (cache->shownEntry == TREE_INVALID_INDEX) { return false; }
+	return IsTreeBitSet(&cache->entries[cache->shownEntry].branchBits, branchIndex);
+}
+
+void StartTreeChainEntry(TreeChainCache* cache, SkillTree* tree, TreeChainEntry* entry, TreeNodeHandle node, bool isWalk)
+{
+	entry->node = node;
+	entry->isComplete = false;
+	entry->isWalk = isWalk;
+	VarArrayClear(&entry->upstreamNodes, false);
+	VarArrayClear(&entry->downstreamNodes, false);
+	if (entry->branchBits.length > 0) { MyMemSet(entry->branchBits.items, 0x00, sizeof(u64) * entry->branchBits.length); }
+	entry->upstreamCursor = 0;
+	entry->downstreamCursor = 0;
+	
+	*VarArrayAdd(u32, &entry->upstreamNodes) = node.index;
+	*VarArrayAdd(u32, &entry->downstreamNodes) = node.index;
+	if (!isWalk)
+	{
+		const TreeNode* nodePntr = GetTreeNodeByHandle(tree, node);
+		FindTreeNodePrerequisites(cache->reach, tree, nodePntr, &entry->upstreamNodes);
+		FindTreeNodeDependents(cache->reach, tree, nodePntr, &entry->downstreamNodes);
+		return;
+	}
+	
+	// Marks are stamped rather than cleared, so we only have to wipe them when the stamp wraps around
+	while (cache->upstreamMarks.length < tree->nodes.length)
+	{
+		*VarArrayAdd(u32, &cache->upstreamMarks) = 0;
+		*VarArrayAdd(u32, &cache->downstreamMarks) = 0;
+	}
+	cache->walkStamp++;
+	if (cache->walkStamp == 0)
+	{
+		MyMemSet(cache->upstreamMarks.items, 0x00, sizeof(u32) * cache->upstreamMarks.length);
+		MyMemSet(cache->downstreamMarks.items, 0x00, sizeof(u32) * cache->downstreamMarks.length);
+		cache->walkStamp = 1;
+	}
+	*VarArrayGetHard(u32, &cache->upstreamMarks, node.index) = cache->walkStamp;
+	*VarArrayGetHard(u32, &cache->downstreamMarks, node.index) = cache->walkStamp;
+}
+
+// Marks the Dependency branches leading into the upstream nodes and out of the downstream nodes until they're all done or
+// workBudget references have been visited (a walk also queues the node at the other end of each branch the first time it's reached).
+// The budget is checked between nodes so one node's references are never split across calls. Returns true once the entry is complete
+bool StepTreeChainEntry(TreeChainCache* cache, SkillTree* tree, TreeChainEntry* entry, uxx workBudget)
+{
+	TreeNodeRefsView allNodeRefs = GetTreeNodeRefsView(tree);
+	TreeReferenceView refs = GetTreeReferencesView(tree);
+	uxx numVisited = 0;
+	for (uxx dIndex = 0; dIndex < 2; dIndex++)
+	{
+		bool isUpstream = (dIndex == 0);
+		VarArray* chainNodes = isUpstream ? &entry->upstreamNodes : &entry->downstreamNodes;
+		uxx* cursor = isUpstream ? &entry->upstreamCursor : &entry->downstreamCursor;
+		u32* marks = (u32*)(isUpstream ? cache->upstreamMarks.items : cache->downstreamMarks.items);
+		uxx partition = GetTreeRefPartition(isUpstream, TreeBranchType_Dependency);
+		while (*cursor < chainNodes->length)
+		{
+			if (numVisited >= workBudget) { return false; }
+			u32 nodeIndex = *VarArrayGetHard(u32, chainNodes, *cursor);
+			(*cursor)++;
+			const TreeNodeRefs* nodeRefs = &TreeViewAt(allNodeRefs, nodeIndex);
+			for (uxx rIndex = nodeRefs->partitionStarts[partition]; rIndex < nodeRefs->partitionStarts[partition+1]; rIndex++)
+			{
+				const TreeReference* reference = &TreeViewAt(refs, rIndex);
+				numVisited++;
+				SetTreeBit(&entry->branchBits, reference->branchIndex, true);
+				if (!entry->isWalk || reference->nodeIndex == TREE_INVALID_INDEX || marks[reference->nodeIndex] == cache->walkStamp) { continue; }
+				marks[reference->nodeIndex] = cache->walkStamp;
+				*VarArrayAdd(u32, chainNodes) = reference->nodeIndex;
+			}
+		}
+	}
+	entry->isComplete = true;
+	return true;
+}
+
+// Call once a frame with the node to highlight (an empty handle, or one that doesn't resolve, clears the highlight).
+// Returns true if IsTreeBranchOnChain covers the node's whole chain, false if it's still being walked
+bool UpdateTreeChainHighlight(TreeChainCache* cache, SkillTree* tree, TreeNodeHandle node, uxx workBudget)
+{
+	NotNull(cache);
+	NotNull(cache->arena);
+	NotNull(tree);
+	Assert(workBudget > 0);
+	if (cache->builtVersion != tree->dependencyVersion)
+	{
+		cache->shownEntry = TREE_INVALID_INDEX;
+		for (uxx eIndex = 0; eIndex < TREE_CHAIN_CACHE_SIZE; eIndex++) { cache->entries[eIndex].node = TreeNodeHandle_Empty; }
+		cache->builtVersion = tree->dependencyVersion;
+	}
+	if (!tree->referencesBaked || GetTreeNodeByHandle(tree, node) == nullptr)
+	{
+		cache->shownEntry = TREE_INVALID_INDEX;
+		return true;
+	}
+	
+	uxx entryIndex = TREE_INVALID_INDEX;
+	for (uxx eIndex = 0; eIndex < TREE_CHAIN_CACHE_SIZE; eIndex++)
+	{
+		if (AreEqualTreeNodeHandles(cache->entries[eIndex].node, node)) { entryIndex = eIndex; break; }
+	}
+	if (entryIndex == TREE_INVALID_INDEX)
+	{
+		// A walk that was cut short when the hover moved on can't be picked back up once a new walk reuses the marks, so it's dropped
+		bool isWalk = !IsTreeReachIndexCurrent(cache->reach, tree);
+		for (uxx eIndex = 0; eIndex < TREE_CHAIN_CACHE_SIZE && isWalk; eIndex++)
+		{
+			if (cache->entries[eIndex].isWalk && !cache->entries[eIndex].isComplete) { cache->entries[eIndex].node = TreeNodeHandle_Empty; }
+		}
+		entryIndex = 0;
+		for (uxx eIndex = 0; eIndex < TREE_CHAIN_CACHE_SIZE; eIndex++)
+		{
+			const TreeChainEntry* entry = &cache->entries[eIndex];
+			if (IsEmptyTreeNodeHandle(entry->node)) { entryIndex = eIndex; break; }
+			if (entry->lastUsed < cache->entries[entryIndex].lastUsed) { entryIndex = eIndex; }
+		}
+		StartTreeChainEntry(cache, tree, &cache->entries[entryIndex], node, isWalk);
+	}
+	
+	TreeChainEntry* entry = &cache->entries[entryIndex];
+	cache->useCounter++;
+	entry->lastUsed = cache->useCounter;
+	cache->shownEntry = entryIndex;
+	if (!entry->isComplete) { StepTreeChainEntry(cache, tree, entry, workBudget); }
+	return entry->isComplete;
+}
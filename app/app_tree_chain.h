@@ -0,0 +1,50 @@
+/*
+File:   app_tree_chain.h
+Author: Taylor Robbins
+Date:   10\17\2026
+*/
+
+#ifndef _APP_TREE_CHAIN_H
+#define _APP_TREE_CHAIN_H
+
+#define TREE_CHAIN_CACHE_SIZE  8 //recently hovered nodes whose chains are kept around
+
+// Everything upstream (prerequisites) and downstream (dependents) of one node along Dependency branches.
+// Everything before the cursors has had its Dependency branches marked in branchBits
+typedef struct TreeChainEntry TreeChainEntry;
+struct TreeChainEntry
+{
+	TreeNodeHandle node; //empty for unused entries
+	u64 lastUsed; //TreeChainCache::useCounter when this was last shown
+	bool isComplete;
+	bool isWalk; //the node lists are the queues of two breadth-first walks (the reach index wasn't current when this started)
+	VarArray upstreamNodes; //u32 node indices, starting with the node itself
+	VarArray downstreamNodes; //u32 node indices, starting with the node itself
+	VarArray branchBits; //u64 (by branch index) the Dependency branches marked so far
+	uxx upstreamCursor;
+	uxx downstreamCursor;
+};
+
+// Finds the full Dependency chains of one node (usually the hovered one) so IsTreeBranchOnChain can highlight them. If the TreeReachIndex
+// is current the nodes on the chains come straight from it, otherwise they're found by a breadth-first walk (the cache never rebuilds
+// the index itself, that's a full pass over the tree). Either way at most workBudget references are visited per call, so a hub with a
+// huge chain fills in over a few frames instead of stalling one. The last TREE_CHAIN_CACHE_SIZE chains keep their own bits, so hovering
+// back and forth between nodes is free, until the tree's dependencyVersion changes and they're all dropped. A chain read from the index
+// doesn't continue past nodes that are in (or downstream of) a Dependency cycle, a walked one goes around the cycle
+typedef struct TreeChainCache TreeChainCache;
+struct TreeChainCache
+{
+	Arena* arena;
+	TreeReachIndex* reach;
+	u64 builtVersion; //SkillTree::dependencyVersion the entries were found in
+	u64 useCounter;
+	TreeChainEntry entries[TREE_CHAIN_CACHE_SIZE];
+	uxx shownEntry; //the entry IsTreeBranchOnChain reads (TREE_INVALID_INDEX for none)
+	
+	// Marks for the walk in progress (by node index, equal to walkStamp if the node was already reached in that direction)
+	u32 walkStamp;
+	VarArray upstreamMarks; //u32
+	VarArray downstreamMarks; //u32
+};
+
+#endif //  _APP_TREE_CHAIN_H
@@ -0,0 +1,566 @@
+/*
+File:   app_tree_communities.c
+Author: Taylor Robbins
+Date:   10\17\2026
+Description:
+	** Holds TreeCommunities which runs Louvain community detection over the branches
+	** of a TreeSnapshot on a worker thread and colors the nodes by the community they're in
+*/
+
+void CancelTreeCommunityJob(TreeCommunities* communities)
+{
+	NotNull(communities);
+	if (!communities->hasJob) { return; }
+	TreeAtomicExchangeU64(&communities->cancelJob, 1);
+	// The worker checks cancelJob every TREE_COMMUNITY_CANCEL_INTERVAL nodes so this doesn't spin for long
+	while (TreeAtomicLoadU64(&communities->isJobRunning) != 0) { }
+	ReleaseTreeSnapshot(communities->jobSnapshot);
+	communities->jobSnapshot = nullptr;
+	communities->hasJob = false;
+}
+
+void FreeTreeCommunities(TreeCommunities* communities)
+{
+	NotNull(communities);
+	if (communities->arena != nullptr)
+	{
+		CancelTreeCommunityJob(communities);
+		if (communities->prevSnapshot != nullptr) { ReleaseTreeSnapshot(communities->prevSnapshot); }
+		UnregisterTreeSnapshotReader(communities->publisher, communities->readerIndex);
+		FreeVarArray(&communities->labels[0]);
+		FreeVarArray(&communities->labels[1]);
+		if (communities->workMemory != nullptr) { FreeArray(u8, communities->arena, communities->workSize, communities->workMemory); }
+	}
+	ClearPointer(communities);
+}
+
+void InitTreeCommunities(Arena* arena, TreeSnapshotPublisher* publisher, TreeCommunities* communitiesOut)
+{
+	NotNull(arena);
+	NotNull(publisher);
+	NotNull(communitiesOut);
+	ClearPointer(communitiesOut);
+	communitiesOut->arena = arena;
+	communitiesOut->publisher = publisher;
+	communitiesOut->readerIndex = RegisterTreeSnapshotReader(publisher);
+	InitVarArray(u32, &communitiesOut->labels[0], arena);
+	InitVarArray(u32, &communitiesOut->labels[1], arena);
+	Color32 palette[TREE_COMMUNITY_PALETTE_SIZE] = {
+		MonokaiBlue, MonokaiGreen, MonokaiOrange, MonokaiPurple, MonokaiYellow, MonokaiMagenta,
+		MonokaiRed, MonokaiLightBlue, MonokaiDarkGreen, MonokaiLightPurple, MonokaiBrown, MonokaiLightRed,
+	};
+	MyMemCopy(&communitiesOut->palette[0], &palette[0], sizeof(palette));
+}
+
+// Labels are node indices so neighboring communities often have labels close together, mixing them first spreads those out over the palette
+Color32 GetTreeCommunityColor(const TreeCommunities* communities, u32 label)
+{
+	return communities->palette[((label * 0x9E3779B1u) >> 16) % TREE_COMMUNITY_PALETTE_SIZE];
+}
+
+// Pass a nullptr memory to get the size without carving anything
+uxx CarveTreeCommunityWork(u8* memory, uxx numNodes, uxx numEdges, TreeCommunityWork* workOut)
+{
+	uxx size = 0;
+	#define CarveTreeCommunityArray(type, pntr, count) do { size = (size + 7) & ~(uxx)7; if (memory != nullptr) { (pntr) = (type*)(memory + size); } size += sizeof(type) * (count); } while(0)
+	TreeCommunityWork work = ZEROED;
+	for (uxx gIndex = 0; gIndex < ArrayCount(work.graphs); gIndex++)
+	{
+		CarveTreeCommunityArray(u32, work.graphs[gIndex].edgeStarts, numNodes + 1);
+		CarveTreeCommunityArray(u32, work.graphs[gIndex].edgeNodes, numEdges);
+		CarveTreeCommunityArray(r32, work.graphs[gIndex].edgeWeights, numEdges);
+		CarveTreeCommunityArray(r64, work.graphs[gIndex].degrees, numNodes);
+	}
+	CarveTreeCommunityArray(u8, work.nodeFlags, numNodes);
+	CarveTreeCommunityArray(u8, work.resetLabels, numNodes);
+	CarveTreeCommunityArray(u32, work.nodeLevels, numNodes);
+	CarveTreeCommunityArray(u32, work.levelLabels, numNodes);
+	CarveTreeCommunityArray(r64, work.communityDegrees, numNodes);
+	CarveTreeCommunityArray(r64, work.neighborWeights, numNodes);
+	CarveTreeCommunityArray(u32, work.neighborCommunities, numNodes);
+	CarveTreeCommunityArray(u32, work.queue, numNodes);
+	CarveTreeCommunityArray(u8, work.isQueued, numNodes);
+	CarveTreeCommunityArray(u8, work.isActive, numNodes);
+	CarveTreeCommunityArray(u32, work.communityIndices, numNodes);
+	CarveTreeCommunityArray(u32, work.memberStarts, numNodes + 1);
+	CarveTreeCommunityArray(u32, work.members, numNodes);
+	#undef CarveTreeCommunityArray
+	if (memory != nullptr) { SetOptionalOutPntr(workOut, work); }
+	return size;
+}
+
+// +==============================+
+// |            Worker            |
+// +==============================+
+// The node a branch end resolves to in the snapshot, or TREE_INVALID_INDEX if it's not linked (or the node it was linked to is gone)
+u32 GetTreeCommunityNodeIndex(const TreeSnapshot* snapshot, TreeNodeHandle handle)
+{
+	if (IsEmptyTreeNodeHandle(handle) || handle.index >= snapshot->numNodeSlots) { return TREE_INVALID_INDEX; }
+	return (GetTreeSnapshotNode(snapshot, handle.index)->generation == handle.generation) ? handle.index : TREE_INVALID_INDEX;
+}
+
+void ResetTreeCommunityLabel(u8* resetLabels, const u32* prevLabels, uxx numPrevLabels, u32 nodeIndex)
+{
+	if (nodeIndex < numPrevLabels && prevLabels[nodeIndex] != TREE_INVALID_INDEX) { resetLabels[prevLabels[nodeIndex]] = 1; }
+}
+
+// Compares the snapshot against prevSnapshot (pages that weren't touched are shared between them so those are skipped with a pointer compare).
+// Nodes that are new in their slot are marked TREE_COMMUNITY_NODE_CHANGED, and the last run's communities that had a node removed
+// or a branch added/removed/relinked get marked in resetLabels. Returns false if nothing changed that would matter to the communities
+bool FindTreeCommunityChanges(const TreeSnapshot* snapshot, const TreeSnapshot* prevSnapshot, const u32* prevLabels, uxx numPrevLabels, TreeCommunityWork* work)
+{
+	bool result = false;
+	uxx numNodePages = (snapshot->numNodePages > prevSnapshot->numNodePages) ? snapshot->numNodePages : prevSnapshot->numNodePages;
+	for (uxx pIndex = 0; pIndex < numNodePages; pIndex++)
+	{
+		TreeSnapshotNodePage* page = (pIndex < snapshot->numNodePages) ? snapshot->nodePages[pIndex] : nullptr;
+		TreeSnapshotNodePage* prevPage = (pIndex < prevSnapshot->numNodePages) ? prevSnapshot->nodePages[pIndex] : nullptr;
+		if (page == prevPage) { continue; }
+		for (uxx sIndex = 0; sIndex < TREE_SNAPSHOT_PAGE_SIZE; sIndex++)
+		{
+			uxx nodeIndex = pIndex * TREE_SNAPSHOT_PAGE_SIZE + sIndex;
+			u32 generation = (page != nullptr && nodeIndex < snapshot->numNodeSlots) ? page->nodes[sIndex].generation : 0;
+			u32 prevGeneration = (prevPage != nullptr && nodeIndex < prevSnapshot->numNodeSlots) ? prevPage->nodes[sIndex].generation : 0;
+			if (generation == prevGeneration) { continue; } //moved, renamed or recolored
+			if (IsTreeSlotGenerationAlive(prevGeneration)) { ResetTreeCommunityLabel(work->resetLabels, prevLabels, numPrevLabels, (u32)nodeIndex); }
+			if (IsTreeSlotGenerationAlive(generation)) { work->nodeFlags[nodeIndex] |= TREE_COMMUNITY_NODE_CHANGED; }
+			result = true;
+		}
+	}
+	
+	uxx numBranchPages = (snapshot->numBranchPages > prevSnapshot->numBranchPages) ? snapshot->numBranchPages : prevSnapshot->numBranchPages;
+	for (uxx pIndex = 0; pIndex < numBranchPages; pIndex++)
+	{
+		TreeSnapshotBranchPage* page = (pIndex < snapshot->numBranchPages) ? snapshot->branchPages[pIndex] : nullptr;
+		TreeSnapshotBranchPage* prevPage = (pIndex < prevSnapshot->numBranchPages) ? prevSnapshot->branchPages[pIndex] : nullptr;
+		if (page == prevPage) { continue; }
+		for (uxx sIndex = 0; sIndex < TREE_SNAPSHOT_PAGE_SIZE; sIndex++)
+		{
+			uxx branchIndex = pIndex * TREE_SNAPSHOT_PAGE_SIZE + sIndex;
+			const TreeBranch* branch = (page != nullptr && branchIndex < snapshot->numBranchSlots) ? &page->branches[sIndex] : nullptr;
+			const TreeBranch* prevBranch = (prevPage != nullptr && branchIndex < prevSnapshot->numBranchSlots) ? &prevPage->branches[sIndex] : nullptr;
+			bool isAlive = (branch != nullptr && IsTreeSlotGenerationAlive(branch->generation));
+			bool wasAlive = (prevBranch != nullptr && IsTreeSlotGenerationAlive(prevBranch->generation));
+			if (!isAlive && !wasAlive) { continue; }
+			if (isAlive && wasAlive && branch->generation == prevBranch->generation &&
+				AreEqualTreeNodeHandles(branch->fromHandle, prevBranch->fromHandle) &&
+				AreEqualTreeNodeHandles(branch->toHandle, prevBranch->toHandle))
+			{
+				continue; //renamed
+			}
+			if (wasAlive)
+			{
+				ResetTreeCommunityLabel(work->resetLabels, prevLabels, numPrevLabels, GetTreeCommunityNodeIndex(prevSnapshot, prevBranch->fromHandle));
+				ResetTreeCommunityLabel(work->resetLabels, prevLabels, numPrevLabels, GetTreeCommunityNodeIndex(prevSnapshot, prevBranch->toHandle));
+			}
+			if (isAlive)
+			{
+				ResetTreeCommunityLabel(work->resetLabels, prevLabels, numPrevLabels, GetTreeCommunityNodeIndex(snapshot, branch->fromHandle));
+				ResetTreeCommunityLabel(work->resetLabels, prevLabels, numPrevLabels, GetTreeCommunityNodeIndex(snapshot, branch->toHandle));
+			}
+			result = true;
+		}
+	}
+	return result;
+}
+
+// Every branch with both ends linked becomes an edge with a weight of 1 (branches between the same two nodes just add up)
+void BuildTreeCommunityGraph(const TreeSnapshot* snapshot, u32* cursors, TreeCommunityGraph* graph)
+{
+	uxx numNodes = snapshot->numNodeSlots;
+	graph->numNodes = numNodes;
+	MyMemSet(graph->edgeStarts, 0x00, sizeof(u32) * (numNodes + 1));
+	MyMemSet(graph->degrees, 0x00, sizeof(r64) * numNodes);
+	for (uxx bIndex = 0; bIndex < snapshot->numBranchSlots; bIndex++)
+	{
+		const TreeBranch* branch = GetTreeSnapshotBranch(snapshot, bIndex);
+		if (!IsTreeSlotGenerationAlive(branch->generation)) { continue; }
+		u32 fromIndex = GetTreeCommunityNodeIndex(snapshot, branch->fromHandle);
+		u32 toIndex = GetTreeCommunityNodeIndex(snapshot, branch->toHandle);
+		if (fromIndex == TREE_INVALID_INDEX || toIndex == TREE_INVALID_INDEX) { continue; }
+		if (fromIndex == toIndex) { graph->degrees[fromIndex] += 2.0; continue; }
+		graph->edgeStarts[fromIndex + 1]++;
+		graph->edgeStarts[toIndex + 1]++;
+	}
+	for (uxx nIndex = 0; nIndex < numNodes; nIndex++)
+	{
+		graph->edgeStarts[nIndex + 1] += graph->edgeStarts[nIndex];
+		cursors[nIndex] = graph->edgeStarts[nIndex];
+	}
+	for (uxx bIndex = 0; bIndex < snapshot->numBranchSlots; bIndex++)
+	{
+		const TreeBranch* branch = GetTreeSnapshotBranch(snapshot, bIndex);
+		if (!IsTreeSlotGenerationAlive(branch->generation)) { continue; }
+		u32 fromIndex = GetTreeCommunityNodeIndex(snapshot, branch->fromHandle);
+		u32 toIndex = GetTreeCommunityNodeIndex(snapshot, branch->toHandle);
+		if (fromIndex == TREE_INVALID_INDEX || toIndex == TREE_INVALID_INDEX || fromIndex == toIndex) { continue; }
+		graph->edgeNodes[cursors[fromIndex]] = toIndex;
+		graph->edgeWeights[cursors[fromIndex]++] = 1.0f;
+		graph->edgeNodes[cursors[toIndex]] = fromIndex;
+		graph->edgeWeights[cursors[toIndex]++] = 1.0f;
+		graph->degrees[fromIndex] += 1.0;
+		graph->degrees[toIndex] += 1.0;
+	}
+	graph->totalWeight = 0;
+	for (uxx nIndex = 0; nIndex < numNodes; nIndex++) { graph->totalWeight += graph->degrees[nIndex]; }
+}
+
+void QueueTreeCommunityNode(TreeCommunityWork* work, uxx numNodes, uxx* queueStart, uxx* queueLength, u32 nodeIndex)
+{
+	if (work->isQueued[nodeIndex]) { return; }
+	Assert(*queueLength < numNodes);
+	work->queue[(*queueStart + *queueLength) % numNodes] = nodeIndex;
+	work->isQueued[nodeIndex] = 1;
+	(*queueLength)++;
+}
+
+// The local moving phase of Louvain. Each queued node moves to whichever neighboring community gains the most modularity:
+//   (weight of its edges into the community) - (its degree) * (the community's degree) / totalWeight
+// and when it moves, the neighbors that aren't in its new community are queued again (so a full pass over every node is only needed
+// for a full run, an incremental run starts with just the reset nodes in the queue). Returns false if the job was cancelled
+bool MoveTreeCommunityNodes(TreeCommunities* communities, TreeCommunityWork* work, const TreeCommunityGraph* graph, uxx queueLength)
+{
+	uxx numNodes = graph->numNodes;
+	if (graph->totalWeight <= 0) //no edges at all, nobody has a reason to move
+	{
+		for (uxx qIndex = 0; qIndex < queueLength; qIndex++) { work->isQueued[work->queue[qIndex]] = 0; }
+		return true;
+	}
+	uxx queueStart = 0;
+	uxx numVisited = 0;
+	while (queueLength > 0)
+	{
+		u32 nodeIndex = work->queue[queueStart];
+		queueStart = (queueStart + 1) % numNodes;
+		queueLength--;
+		work->isQueued[nodeIndex] = 0;
+		numVisited++;
+		if ((numVisited % TREE_COMMUNITY_CANCEL_INTERVAL) == 0 && TreeAtomicLoadU64(&communities->cancelJob) != 0) { return false; }
+		
+		u32 oldCommunity = work->levelLabels[nodeIndex];
+		r64 nodeDegree = graph->degrees[nodeIndex];
+		uxx numNeighborCommunities = 0;
+		for (uxx eIndex = graph->edgeStarts[nodeIndex]; eIndex < graph->edgeStarts[nodeIndex + 1]; eIndex++)
+		{
+			u32 community = work->levelLabels[graph->edgeNodes[eIndex]];
+			if (work->neighborWeights[community] == 0) { work->neighborCommunities[numNeighborCommunities++] = community; }
+			work->neighborWeights[community] += graph->edgeWeights[eIndex];
+		}
+		
+		work->communityDegrees[oldCommunity] -= nodeDegree;
+		u32 bestCommunity = oldCommunity;
+		r64 bestGain = work->neighborWeights[oldCommunity] - nodeDegree * work->communityDegrees[oldCommunity] / graph->totalWeight;
+		for (uxx cIndex = 0; cIndex < numNeighborCommunities; cIndex++)
+		{
+			u32 community = work->neighborCommunities[cIndex];
+			r64 gain = work->neighborWeights[community] - nodeDegree * work->communityDegrees[community] / graph->totalWeight;
+			if (gain > bestGain + TREE_COMMUNITY_MIN_GAIN) { bestGain = gain; bestCommunity = community; }
+			work->neighborWeights[community] = 0;
+		}
+		work->communityDegrees[bestCommunity] += nodeDegree;
+		if (bestCommunity == oldCommunity) { continue; }
+		
+		work->levelLabels[nodeIndex] = bestCommunity;
+		work->isActive[nodeIndex] = 1;
+		communities->jobStats.numMoves++;
+		for (uxx eIndex = graph->edgeStarts[nodeIndex]; eIndex < graph->edgeStarts[nodeIndex + 1]; eIndex++)
+		{
+			u32 neighborIndex = graph->edgeNodes[eIndex];
+			if (work->levelLabels[neighborIndex] != bestCommunity) { QueueTreeCommunityNode(work, numNodes, &queueStart, &queueLength, neighborIndex); }
+		}
+	}
+	return true;
+}
+
+// Collapses every community of graph into one node of aggregateOut (with the edges between two communities added up into one edge)
+// and moves nodeLevels along. Returns the number of nodes in aggregateOut
+uxx AggregateTreeCommunityGraph(TreeCommunityWork* work, const TreeCommunityGraph* graph, uxx numBaseNodes, TreeCommunityGraph* aggregateOut)
+{
+	uxx numNodes = graph->numNodes;
+	uxx numCommunities = 0;
+	for (uxx nIndex = 0; nIndex < numNodes; nIndex++) { work->communityIndices[nIndex] = TREE_INVALID_INDEX; }
+	for (uxx nIndex = 0; nIndex < numNodes; nIndex++)
+	{
+		u32 community = work->levelLabels[nIndex];
+		if (community == TREE_INVALID_INDEX) { continue; } //free node slot
+		if (work->communityIndices[community] == TREE_INVALID_INDEX) { work->communityIndices[community] = (u32)numCommunities++; }
+	}
+	
+	// Group the nodes by their community (a counting sort) so each community's edges can be gathered in one go
+	MyMemSet(work->memberStarts, 0x00, sizeof(u32) * (numCommunities + 1));
+	for (uxx nIndex = 0; nIndex < numNodes; nIndex++)
+	{
+		if (work->levelLabels[nIndex] == TREE_INVALID_INDEX) { continue; }
+		work->memberStarts[work->communityIndices[work->levelLabels[nIndex]] + 1]++;
+	}
+	for (uxx cIndex = 0; cIndex < numCommunities; cIndex++) { work->memberStarts[cIndex + 1] += work->memberStarts[cIndex]; }
+	for (uxx nIndex = 0; nIndex < numNodes; nIndex++)
+	{
+		if (work->levelLabels[nIndex] == TREE_INVALID_INDEX) { continue; }
+		u32 community = work->communityIndices[work->levelLabels[nIndex]];
+		work->members[work->memberStarts[community]++] = (u32)nIndex;
+	}
+	for (uxx cIndex = numCommunities; cIndex > 0; cIndex--) { work->memberStarts[cIndex] = work->memberStarts[cIndex - 1]; }
+	work->memberStarts[0] = 0;
+	
+	aggregateOut->numNodes = numCommunities;
+	aggregateOut->totalWeight = graph->totalWeight;
+	uxx numEdges = 0;
+	for (uxx cIndex = 0; cIndex < numCommunities; cIndex++)
+	{
+		aggregateOut->edgeStarts[cIndex] = (u32)numEdges;
+		aggregateOut->degrees[cIndex] = 0;
+		uxx numNeighborCommunities = 0;
+		bool isActive = false;
+		for (uxx mIndex = work->memberStarts[cIndex]; mIndex < work->memberStarts[cIndex + 1]; mIndex++)
+		{
+			u32 nodeIndex = work->members[mIndex];
+			aggregateOut->degrees[cIndex] += graph->degrees[nodeIndex];
+			if (work->isActive[nodeIndex]) { isActive = true; }
+			for (uxx eIndex = graph->edgeStarts[nodeIndex]; eIndex < graph->edgeStarts[nodeIndex + 1]; eIndex++)
+			{
+				u32 community = work->communityIndices[work->levelLabels[graph->edgeNodes[eIndex]]];
+				if (community == cIndex) { continue; } //inside the community, only counts towards its degree
+				if (work->neighborWeights[community] == 0) { work->neighborCommunities[numNeighborCommunities++] = community; }
+				work->neighborWeights[community] += graph->edgeWeights[eIndex];
+			}
+		}
+		for (uxx nIndex = 0; nIndex < numNeighborCommunities; nIndex++)
+		{
+			u32 community = work->neighborCommunities[nIndex];
+			aggregateOut->edgeNodes[numEdges] = community;
+			aggregateOut->edgeWeights[numEdges] = (r32)work->neighborWeights[community];
+			numEdges++;
+			work->neighborWeights[community] = 0;
+		}
+		// isQueued is all zeroes between local moving phases, so it holds the next level's isActive until we're done reading this level's
+		work->isQueued[cIndex] = isActive ? 1 : 0;
+	}
+	aggregateOut->edgeStarts[numCommunities] = (u32)numEdges;
+	MyMemCopy(work->isActive, work->isQueued, numCommunities);
+	MyMemSet(work->isQueued, 0x00, numCommunities);
+	
+	for (uxx nIndex = 0; nIndex < numBaseNodes; nIndex++)
+	{
+		if (work->nodeLevels[nIndex] == TREE_INVALID_INDEX) { continue; }
+		work->nodeLevels[nIndex] = work->communityIndices[work->levelLabels[work->nodeLevels[nIndex]]];
+	}
+	return numCommunities;
+}
+
+// Runs on the worker thread. Reads labels[currentLabels] (found in prevSnapshot) and jobSnapshot, writes the other labels buffer.
+// Returns false if the job was cancelled partway through (the output labels are garbage then)
+bool RunTreeCommunityJob(TreeCommunities* communities)
+{
+	NotNull(communities);
+	const TreeSnapshot* snapshot = communities->jobSnapshot;
+	const TreeSnapshot* prevSnapshot = communities->prevSnapshot;
+	const VarArray* prevLabelsArray = &communities->labels[communities->currentLabels];
+	VarArray* labelsArray = &communities->labels[communities->currentLabels ^ 1];
+	const u32* prevLabels = (const u32*)prevLabelsArray->items;
+	uxx numPrevLabels = prevLabelsArray->length;
+	u32* labels = (u32*)labelsArray->items;
+	uxx numNodes = snapshot->numNodeSlots;
+	Assert(labelsArray->length == numNodes);
+	TreeCommunityStats* stats = &communities->jobStats;
+	ClearPointer(stats);
+	communities->jobChangedNothing = false;
+	
+	TreeCommunityWork work = ZEROED;
+	CarveTreeCommunityWork(communities->workMemory, (numNodes > numPrevLabels) ? numNodes : numPrevLabels, 2 * snapshot->numBranchSlots, &work);
+	MyMemSet(work.nodeFlags, 0x00, numNodes);
+	MyMemSet(work.resetLabels, 0x00, (numNodes > numPrevLabels) ? numNodes : numPrevLabels);
+	
+	bool isFullRun = (prevSnapshot == nullptr);
+	if (!isFullRun && !FindTreeCommunityChanges(snapshot, prevSnapshot, prevLabels, numPrevLabels, &work))
+	{
+		for (uxx nIndex = 0; nIndex < numNodes; nIndex++) { labels[nIndex] = (nIndex < numPrevLabels) ? prevLabels[nIndex] : TREE_INVALID_INDEX; }
+		communities->jobChangedNothing = true;
+		return true;
+	}
+	
+	// Nodes in a community that an edit touched start over by themselves, the rest stay where they were. Every kept label is
+	// the index of a node that kept it too (see the end of this function) so it can't collide with the index of a reset node
+	uxx numLiveNodes = 0;
+	for (uxx nIndex = 0; nIndex < numNodes; nIndex++)
+	{
+		if (!IsTreeSlotGenerationAlive(GetTreeSnapshotNode(snapshot, nIndex)->generation)) { continue; }
+		numLiveNodes++;
+		bool isReset = (isFullRun || nIndex >= numPrevLabels || prevLabels[nIndex] == TREE_INVALID_INDEX ||
+			IsFlagSet(work.nodeFlags[nIndex], TREE_COMMUNITY_NODE_CHANGED) || work.resetLabels[prevLabels[nIndex]]);
+		if (isReset) { work.nodeFlags[nIndex] |= TREE_COMMUNITY_NODE_RESET; stats->numResetNodes++; }
+	}
+	if (!isFullRun && stats->numResetNodes * TREE_COMMUNITY_FULL_RUN_DIVISOR > numLiveNodes) { isFullRun = true; stats->numResetNodes = numLiveNodes; }
+	stats->wasFullRun = isFullRun;
+	
+	TreeCommunityGraph* graph = &work.graphs[0];
+	BuildTreeCommunityGraph(snapshot, work.queue, graph);
+	MyMemSet(work.communityDegrees, 0x00, sizeof(r64) * numNodes);
+	MyMemSet(work.neighborWeights, 0x00, sizeof(r64) * numNodes);
+	MyMemSet(work.isQueued, 0x00, numNodes);
+	uxx queueLength = 0;
+	for (uxx nIndex = 0; nIndex < numNodes; nIndex++)
+	{
+		work.isActive[nIndex] = 0;
+		if (!IsTreeSlotGenerationAlive(GetTreeSnapshotNode(snapshot, nIndex)->generation))
+		{
+			work.levelLabels[nIndex] = TREE_INVALID_INDEX;
+			work.nodeLevels[nIndex] = TREE_INVALID_INDEX;
+			continue;
+		}
+		work.nodeLevels[nIndex] = (u32)nIndex;
+		if (isFullRun || IsFlagSet(work.nodeFlags[nIndex], TREE_COMMUNITY_NODE_RESET))
+		{
+			work.levelLabels[nIndex] = (u32)nIndex;
+			work.isActive[nIndex] = 1;
+			work.queue[queueLength++] = (u32)nIndex;
+			work.isQueued[nIndex] = 1;
+		}
+		else { work.levelLabels[nIndex] = prevLabels[nIndex]; }
+		work.communityDegrees[work.levelLabels[nIndex]] += graph->degrees[nIndex];
+	}
+	
+	// Louvain proper: move nodes between communities until nothing improves, then collapse each community into a node and repeat on
+	// that smaller graph. In an incremental run only the aggregated nodes that contain a reset or moved node are queued at each level
+	uxx numLevelNodes = numLiveNodes;
+	for (uxx level = 0; level < TREE_COMMUNITY_MAX_LEVELS; level++)
+	{
+		uxx numMovesBefore = stats->numMoves;
+		if (!MoveTreeCommunityNodes(communities, &work, graph, queueLength)) { return false; }
+		if (level > 0 && stats->numMoves == numMovesBefore) { break; }
+		
+		TreeCommunityGraph* aggregate = &work.graphs[(level + 1) % 2];
+		uxx numCommunities = AggregateTreeCommunityGraph(&work, graph, numNodes, aggregate);
+		bool didShrink = (numCommunities < numLevelNodes);
+		graph = aggregate;
+		numLevelNodes = numCommunities;
+		queueLength = 0;
+		for (uxx nIndex = 0; nIndex < numLevelNodes; nIndex++)
+		{
+			work.levelLabels[nIndex] = (u32)nIndex;
+			work.communityDegrees[nIndex] = graph->degrees[nIndex];
+			if (isFullRun || work.isActive[nIndex])
+			{
+				work.queue[queueLength++] = (u32)nIndex;
+				work.isQueued[nIndex] = 1;
+			}
+		}
+		if (!didShrink) { break; } //every community was a single node, the next level would look the same as this one
+	}
+	
+	// Each community is labeled by one of its nodes. Whenever possible that's the node that labeled it last time so the colors of
+	// communities that an edit didn't touch (or only grew) stay the same. communityIndices is free to reuse as the label of each community
+	u32* communityLabels = work.communityIndices;
+	for (uxx nIndex = 0; nIndex < numNodes; nIndex++) { communityLabels[nIndex] = TREE_INVALID_INDEX; }
+	for (uxx nIndex = 0; nIndex < numNodes; nIndex++)
+	{
+		if (work.nodeLevels[nIndex] == TREE_INVALID_INDEX) { continue; }
+		bool wasLabel = (nIndex < numPrevLabels && prevLabels[nIndex] == nIndex && !IsFlagSet(work.nodeFlags[nIndex], TREE_COMMUNITY_NODE_CHANGED));
+		u32 community = work.levelLabels[work.nodeLevels[nIndex]];
+		if (wasLabel && communityLabels[community] == TREE_INVALID_INDEX) { communityLabels[community] = (u32)nIndex; }
+	}
+	for (uxx nIndex = 0; nIndex < numNodes; nIndex++)
+	{
+		if (work.nodeLevels[nIndex] == TREE_INVALID_INDEX) { labels[nIndex] = TREE_INVALID_INDEX; continue; }
+		u32 community = work.levelLabels[work.nodeLevels[nIndex]];
+		if (communityLabels[community] == TREE_INVALID_INDEX) { communityLabels[community] = (u32)nIndex; }
+		if (communityLabels[community] == nIndex) { stats->numCommunities++; }
+		labels[nIndex] = communityLabels[community];
+	}
+	return true;
+}
+
+// PlatformThreadFunc_f
+PLATFORM_THREAD_FUNC_DEF(TreeCommunityThreadMain)
+{
+	TreeCommunities* communities = (TreeCommunities*)contextPntr;
+	communities->jobCancelled = !RunTreeCommunityJob(communities);
+	TreeAtomicExchangeU64(&communities->isJobRunning, 0);
+}
+
+// +==============================+
+// |         Main Thread          |
+// +==============================+
+// Colors every node by the label it got in the job that just finished. Only nodes whose color actually changes are written, so a
+// run that didn't move anything doesn't touch any snapshot pages
+void ApplyTreeCommunityColors(TreeCommunities* communities, SkillTree* tree, const TreeSnapshot* snapshot, const VarArray* labelsArray)
+{
+	const u32* labels = (const u32*)labelsArray->items;
+	TreeNodeView nodes = GetTreeNodesView(tree);
+	TreeColorView colors = GetTreeNodeColorsView(tree);
+	for (uxx nIndex = 0; nIndex < labelsArray->length && nIndex < nodes.count; nIndex++)
+	{
+		if (labels[nIndex] == TREE_INVALID_INDEX) { continue; }
+		TreeNode* node = &TreeViewAt(nodes, nIndex);
+		if (node->generation != GetTreeSnapshotNode(snapshot, nIndex)->generation) { continue; } //removed (or replaced) since the snapshot
+		Color32 color = GetTreeCommunityColor(communities, labels[nIndex]);
+		if (TreeViewAt(colors, nIndex).valueU32 != color.valueU32) { SetTreeNodeColor(tree, node, color); }
+	}
+}
+
+// Call once per frame after PublishTreeSnapshot. Applies the colors from a job that finished, and if the graph has changed since
+// the last job (see GetTreeStructureVersion, dragging nodes around or our own recoloring doesn't count), prepares the next one and returns true.
+// The caller then queues communities->job on the platform's worker (or, if there is none, calls communities->job.function itself which
+// runs the whole job before returning)
+bool UpdateTreeCommunities(TreeCommunities* communities, SkillTree* tree)
+{
+	NotNull(communities);
+	NotNull(communities->arena);
+	NotNull(tree);
+	if (TreeAtomicLoadU64(&communities->isJobRunning) != 0) { return false; }
+	
+	if (communities->hasJob)
+	{
+		TreeSnapshot* jobSnapshot = communities->jobSnapshot;
+		communities->jobSnapshot = nullptr;
+		communities->hasJob = false;
+		if (communities->jobCancelled) { ReleaseTreeSnapshot(jobSnapshot); }
+		else
+		{
+			// If the graph changed while the job was running appliedVersion stays behind so the next job picks those changes up
+			if (!communities->jobChangedNothing)
+			{
+				ApplyTreeCommunityColors(communities, tree, jobSnapshot, &communities->labels[communities->currentLabels ^ 1]);
+				communities->stats = communities->jobStats;
+			}
+			communities->appliedVersion = communities->jobVersion;
+			if (communities->prevSnapshot != nullptr) { ReleaseTreeSnapshot(communities->prevSnapshot); }
+			communities->prevSnapshot = jobSnapshot;
+			communities->currentLabels ^= 1;
+		}
+	}
+	
+	u64 structureVersion = GetTreeStructureVersion(tree);
+	if (structureVersion == communities->appliedVersion) { return false; }
+	TreeSnapshot* snapshot = AcquireTreeSnapshot(communities->publisher, communities->readerIndex);
+	if (snapshot == nullptr) { return false; }
+	if (snapshot == communities->prevSnapshot)
+	{
+		ReleaseTreeSnapshot(snapshot);
+		return false;
+	}
+	
+	uxx numPrevLabels = communities->labels[communities->currentLabels].length;
+	uxx numNodes = (snapshot->numNodeSlots > numPrevLabels) ? snapshot->numNodeSlots : numPrevLabels;
+	uxx workSize = CarveTreeCommunityWork(nullptr, numNodes, 2 * snapshot->numBranchSlots, nullptr);
+	if (workSize > communities->workSize)
+	{
+		if (communities->workMemory != nullptr) { FreeArray(u8, communities->arena, communities->workSize, communities->workMemory); }
+		communities->workSize = workSize + workSize/2; //room to grow so we aren't reallocating after every edit
+		communities->workMemory = AllocArray(u8, communities->arena, communities->workSize);
+		NotNull(communities->workMemory);
+	}
+	VarArray* labelsArray = &communities->labels[communities->currentLabels ^ 1];
+	VarArrayClear(labelsArray, false);
+	if (snapshot->numNodeSlots > 0) { VarArrayAddMulti(u32, labelsArray, snapshot->numNodeSlots); }
+	
+	communities->jobSnapshot = snapshot;
+	communities->jobVersion = structureVersion;
+	communities->hasJob = true;
+	communities->jobCancelled = false;
+	communities->job.function = TreeCommunityThreadMain;
+	communities->job.contextPntr = communities;
+	TreeAtomicExchangeU64(&communities->cancelJob, 0);
+	TreeAtomicExchangeU64(&communities->isJobRunning, 1);
+	return true;
+}
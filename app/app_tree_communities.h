@@ -0,0 +1,100 @@
+/*
+File:   app_tree_communities.h
+Author: Taylor Robbins
+Date:   10\17\2026
+*/
+
+#ifndef _APP_TREE_COMMUNITIES_H
+#define _APP_TREE_COMMUNITIES_H
+
+#define TREE_COMMUNITY_PALETTE_SIZE      12
+#define TREE_COMMUNITY_MAX_LEVELS        16 //aggregation levels, every level shrinks the graph so this is only a safety net
+#define TREE_COMMUNITY_MIN_GAIN          1e-9 //a node only moves if that improves modularity by more than this (keeps rounding from ping-ponging nodes)
+#define TREE_COMMUNITY_FULL_RUN_DIVISOR  4 //if more than 1/4 of the nodes would have to be reset we start over from singletons instead
+#define TREE_COMMUNITY_CANCEL_INTERVAL   1024 //nodes visited between checks of TreeCommunities::cancelJob
+
+#define TREE_COMMUNITY_NODE_CHANGED  0x01 //TreeCommunityWork::nodeFlags, the slot has a different node than it did in the last run (or a node for the first time)
+#define TREE_COMMUNITY_NODE_RESET    0x02 //TreeCommunityWork::nodeFlags, the node started this run in a community by itself
+
+// A weighted undirected graph in compressed-sparse-row form. Each edge is stored at both of its ends.
+// Edges inside a node (self loops, or the edges inside a community once it's aggregated) aren't stored, they only count towards degrees
+typedef struct TreeCommunityGraph TreeCommunityGraph;
+struct TreeCommunityGraph
+{
+	uxx numNodes;
+	u32* edgeStarts; //[numNodes+1]
+	u32* edgeNodes;
+	r32* edgeWeights;
+	r64* degrees; //sum of the weights of every edge touching the node (self loops count twice)
+	r64 totalWeight; //sum of degrees (twice the total edge weight)
+};
+
+// Working memory for one job, carved out of TreeCommunities::workMemory by CarveTreeCommunityWork.
+// Node arrays have room for every node slot (in this snapshot or the last one) and edge arrays for both ends of every branch slot
+typedef struct TreeCommunityWork TreeCommunityWork;
+struct TreeCommunityWork
+{
+	TreeCommunityGraph graphs[2]; //the graph of the current level and the next (aggregated) one
+	u8* nodeFlags; //TREE_COMMUNITY_NODE_ flags, by node slot
+	u8* resetLabels; //by label of the last run, the communities that an edit touched
+	u32* nodeLevels; //by node slot, which node of the current level's graph the node has been aggregated into
+	u32* levelLabels; //by node of the current level's graph, the community it's in
+	r64* communityDegrees; //by community of the current level, sum of its nodes' degrees
+	r64* neighborWeights; //by community of the current level, only non-zero while a node is gathering its neighbors
+	u32* neighborCommunities; //the communities with a non-zero neighborWeights
+	u32* queue; //ring buffer of nodes that still need a visit
+	u8* isQueued;
+	u8* isActive; //by node of the current level's graph, contains a node that was reset or moved (only active nodes are queued in an incremental run)
+	u32* communityIndices; //by community of the current level, the node it becomes in the next level's graph
+	u32* memberStarts; //by node of the next level's graph [numNodes+1], where its members start in members
+	u32* members; //nodes of the current level's graph, grouped by the node of the next level they become
+};
+
+typedef struct TreeCommunityStats TreeCommunityStats;
+struct TreeCommunityStats
+{
+	uxx numCommunities;
+	uxx numResetNodes; //nodes that had to start over in a community by themselves
+	uxx numMoves;
+	bool wasFullRun;
+};
+
+// Finds communities (clusters of nodes that have more branches between them than you'd expect by chance) with the Louvain method
+// on a worker thread and colors the nodes by community. A job reads a TreeSnapshot so it never touches the SkillTree itself.
+// After the first run a job only resets the communities that an edit touched (found by comparing the snapshot's pages against the
+// snapshot of the last run, unchanged pages are shared so that's mostly pointer compares) and everything else starts where it was.
+// Only the nodes in those communities (and the neighbors of anything that moves) are revisited, so a small edit costs a small run.
+// Everything except RunTreeCommunityJob (the worker side) must be called on the thread that edits the tree
+typedef struct TreeCommunities TreeCommunities;
+struct TreeCommunities
+{
+	Arena* arena;
+	TreeSnapshotPublisher* publisher;
+	uxx readerIndex;
+	Color32 palette[TREE_COMMUNITY_PALETTE_SIZE];
+	
+	PlatformWorkerJob job;
+	u64 isJobRunning; //atomic, set before a job starts and cleared by the worker when it's done
+	u64 cancelJob; //atomic
+	bool hasJob; //a job was started and its results haven't been applied yet
+	bool jobCancelled; //set by the worker, only read once isJobRunning is clear
+	bool jobChangedNothing; //set by the worker if no node or branch changed since the last run (the labels are just copied)
+	
+	// Labels are double buffered, the running job reads labels[currentLabels] (the last run's, indexed like prevSnapshot's node slots)
+	// and writes the other one. A label is the index of one of the nodes in the community (that node's own label is its index)
+	TreeSnapshot* prevSnapshot; //the snapshot the current labels were found in (nullptr before the first run)
+	TreeSnapshot* jobSnapshot;
+	VarArray labels[2]; //u32 (TREE_INVALID_INDEX for free slots)
+	uxx currentLabels;
+	u64 jobVersion; //GetTreeStructureVersion when the running job's snapshot was published
+	u64 appliedVersion; //jobVersion of the last job whose colors were applied (moving or recoloring nodes doesn't change it)
+	
+	// Everything the worker needs is allocated up front (sized for the job's snapshot) so it never allocates
+	uxx workSize;
+	u8* workMemory;
+	
+	TreeCommunityStats jobStats; //written by the worker
+	TreeCommunityStats stats; //copied from jobStats when the job's colors are applied
+};
+
+#endif //  _APP_TREE_COMMUNITIES_H
@@ -0,0 +1,133 @@
+/*
+File:   app_tree_diff.c
+Author: Taylor Robbins
+Date:   10\17\2026
+Description:
+	** Holds DiffSkillTrees which uses the content hashes that every SkillTree keeps
+	** to find the nodes and branches that differ between two trees
+*/
+
+bool IsTreeDiffItemLess(const TreeDiffItem* left, const TreeDiffItem* right)
+{
+	if (left->key != right->key) { return (left->key < right->key); }
+	return (left->hash < right->hash);
+}
+
+// Bottom-up merge sort by (key, hash). Buckets can get big when two unrelated trees are compared, so this stays O(n log n)
+void SortTreeDiffItems(TreeDiffItem* items, uxx numItems, TreeDiffItem* tempItems)
+{
+	TreeDiffItem* source = items;
+	TreeDiffItem* dest = tempItems;
+	for (uxx runLength = 1; runLength < numItems; runLength *= 2)
+	{
+		for (uxx runStart = 0; runStart < numItems; runStart += 2 * runLength)
+		{
+			uxx leftIndex = runStart;
+			uxx leftEnd = (runStart + runLength < numItems) ? (runStart + runLength) : numItems;
+			uxx rightIndex = leftEnd;
+			uxx rightEnd = (runStart + 2 * runLength < numItems) ? (runStart + 2 * runLength) : numItems;
+			uxx outIndex = runStart;
+			while (leftIndex < leftEnd && rightIndex < rightEnd)
+			{
+				if (IsTreeDiffItemLess(&source[rightIndex], &source[leftIndex])) { dest[outIndex++] = source[rightIndex++]; }
+				else { dest[outIndex++] = source[leftIndex++]; }
+			}
+			while (leftIndex < leftEnd) { dest[outIndex++] = source[leftIndex++]; }
+			while (rightIndex < rightEnd) { dest[outIndex++] = source[rightIndex++]; }
+		}
+		TreeDiffItem* swap = source; source = dest; dest = swap;
+	}
+	if (source != items) { MyMemCopy(items, source, sizeof(TreeDiffItem) * numItems); }
+}
+
+uxx GatherTreeDiffItems(Arena* arena, SkillTree* tree, bool isBranch, uxx bucket, TreeDiffItem** itemsOut)
+{
+	VarArray* entries = isBranch ? &tree->branchHashEntries : &tree->nodeHashEntries;
+	u32 headIndex = isBranch ? tree->branchHashHeads[bucket] : tree->nodeHashHeads[bucket];
+	uxx numItems = 0;
+	for (u32 index = headIndex; index != TREE_INVALID_INDEX; index = VarArrayGetHard(TreeHashEntry, entries, index)->next) { numItems++; }
+	TreeDiffItem* items = AllocArray(TreeDiffItem, arena, numItems + 1);
+	NotNull(items);
+	uxx itemIndex = 0;
+	for (u32 index = headIndex; index != TREE_INVALID_INDEX; index = VarArrayGetHard(TreeHashEntry, entries, index)->next)
+	{
+		items[itemIndex].key = isBranch ? GetTreeBranchHashKey(VarArrayGetHard(TreeBranch, &tree->branches, index)) : (u64)(*VarArrayGetHard(uxx, &tree->nodeIds, index));
+		items[itemIndex].hash = VarArrayGetHard(TreeHashEntry, entries, index)->hash;
+		items[itemIndex].index = index;
+		itemIndex++;
+	}
+	TreeDiffItem* tempItems = AllocArray(TreeDiffItem, arena, numItems + 1);
+	NotNull(tempItems);
+	SortTreeDiffItems(items, numItems, tempItems);
+	*itemsOut = items;
+	return numItems;
+}
+
+void AddTreeDiffEntry(VarArray* entriesOut, TreeDiffType type, bool isBranch, u32 leftIndex, u32 rightIndex)
+{
+	TreeDiffEntry* newEntry = VarArrayAdd(TreeDiffEntry, entriesOut);
+	NotNull(newEntry);
+	newEntry->type = type;
+	newEntry->isBranch = isBranch;
+	newEntry->leftIndex = leftIndex;
+	newEntry->rightIndex = rightIndex;
+}
+
+// Compares the nodes (or branches) of one bucket. First everything with a matching (key, hash) pair on the other side is dropped,
+// then whatever is left is paired up by key: same key on both sides is Changed, otherwise it's Removed (left) or Added (right)
+void DiffTreeBucket(Arena* scratch, SkillTree* left, SkillTree* right, bool isBranch, uxx bucket, VarArray* entriesOut)
+{
+	TreeDiffItem* leftItems = nullptr;
+	TreeDiffItem* rightItems = nullptr;
+	uxx numLeft = GatherTreeDiffItems(scratch, left, isBranch, bucket, &leftItems);
+	uxx numRight = GatherTreeDiffItems(scratch, right, isBranch, bucket, &rightItems);
+	
+	// The unmatched items are compacted to the front of each array, they stay sorted by key
+	uxx numLeftUnmatched = 0, numRightUnmatched = 0;
+	uxx leftIndex = 0, rightIndex = 0;
+	while (leftIndex < numLeft || rightIndex < numRight)
+	{
+		if (leftIndex < numLeft && rightIndex < numRight && leftItems[leftIndex].key == rightItems[rightIndex].key && leftItems[leftIndex].hash == rightItems[rightIndex].hash)
+		{
+			leftIndex++;
+			rightIndex++;
+		}
+		else if (rightIndex >= numRight || (leftIndex < numLeft && IsTreeDiffItemLess(&leftItems[leftIndex], &rightItems[rightIndex]))) { leftItems[numLeftUnmatched++] = leftItems[leftIndex++]; }
+		else { rightItems[numRightUnmatched++] = rightItems[rightIndex++]; }
+	}
+	
+	leftIndex = 0;
+	rightIndex = 0;
+	while (leftIndex < numLeftUnmatched || rightIndex < numRightUnmatched)
+	{
+		if (leftIndex < numLeftUnmatched && rightIndex < numRightUnmatched && leftItems[leftIndex].key == rightItems[rightIndex].key)
+		{
+			AddTreeDiffEntry(entriesOut, TreeDiffType_Changed, isBranch, leftItems[leftIndex++].index, rightItems[rightIndex++].index);
+		}
+		else if (rightIndex >= numRightUnmatched || (leftIndex < numLeftUnmatched && leftItems[leftIndex].key < rightItems[rightIndex].key))
+		{
+			AddTreeDiffEntry(entriesOut, TreeDiffType_Removed, isBranch, leftItems[leftIndex++].index, TREE_INVALID_INDEX);
+		}
+		else { AddTreeDiffEntry(entriesOut, TreeDiffType_Added, isBranch, TREE_INVALID_INDEX, rightItems[rightIndex++].index); }
+	}
+}
+
+// Appends a TreeDiffEntry to entriesOut for every node and branch that differs between the two trees and returns how many were added.
+// Identical trees cost one hash compare, otherwise only the buckets whose hashes differ are gathered and compared
+uxx DiffSkillTrees(SkillTree* left, SkillTree* right, VarArray* entriesOut)
+{
+	NotNull(left);
+	NotNull(right);
+	NotNull(entriesOut);
+	if (GetTreeRootHash(left) == GetTreeRootHash(right)) { return 0; }
+	uxx numEntriesBefore = entriesOut->length;
+	for (uxx bIndex = 0; bIndex < TREE_HASH_NUM_BUCKETS; bIndex++)
+	{
+		if (left->bucketHashes[bIndex] == right->bucketHashes[bIndex]) { continue; }
+		ScratchBegin2(scratch, left->arena, right->arena);
+		DiffTreeBucket(scratch, left, right, false, bIndex, entriesOut);
+		DiffTreeBucket(scratch, left, right, true, bIndex, entriesOut);
+		ScratchEnd(scratch);
+	}
+	return entriesOut->length - numEntriesBefore;
+}
@@ -0,0 +1,49 @@
+/*
+File:   app_tree_diff.h
+Author: Taylor Robbins
+Date:   10\17\2026
+*/
+
+#ifndef _APP_TREE_DIFF_H
+#define _APP_TREE_DIFF_H
+
+typedef enum TreeDiffType TreeDiffType;
+enum TreeDiffType
+{
+	TreeDiffType_None = 0,
+	TreeDiffType_Added, //only in the right tree
+	TreeDiffType_Removed, //only in the left tree
+	TreeDiffType_Changed, //in both (same node id, or same ends and type for a branch) but the contents differ
+	TreeDiffType_Count,
+};
+const char* GetTreeDiffTypeStr(TreeDiffType enumValue)
+{
+	switch (enumValue)
+	{
+		case TreeDiffType_None:    return "None";
+		case TreeDiffType_Added:   return "Added";
+		case TreeDiffType_Removed: return "Removed";
+		case TreeDiffType_Changed: return "Changed";
+		default: return UNKNOWN_STR;
+	}
+}
+
+typedef struct TreeDiffEntry TreeDiffEntry;
+struct TreeDiffEntry
+{
+	TreeDiffType type;
+	bool isBranch;
+	u32 leftIndex; //node/branch index in the left tree (TREE_INVALID_INDEX for Added)
+	u32 rightIndex; //node/branch index in the right tree (TREE_INVALID_INDEX for Removed)
+};
+
+// The elements of one hash bucket, gathered so both sides can be sorted and walked together
+typedef struct TreeDiffItem TreeDiffItem;
+struct TreeDiffItem
+{
+	u64 key; //node id, or GetTreeBranchHashKey for branches
+	u64 hash;
+	u32 index;
+};
+
+#endif //  _APP_TREE_DIFF_H
@@ -0,0 +1,170 @@
+/*
+File:   app_tree_merge.c
+Author: Taylor Robbins
+Date:   10\17\2026
+Description:
+	** Holds MergeSkillTrees which folds one SkillTree into another, matching nodes
+	** by name and type with a hash join so the whole merge is O(N + B)
+*/
+
+// Lowercased with runs of whitespace collapsed into one space and none at either end, so "  Rust  Lang" matches "rust lang"
+Str8 NormalizeTreeMergeName(Arena* arena, Str8 name)
+{
+	u8* chars = AllocArray(u8, arena, name.length + 1);
+	NotNull(chars);
+	uxx length = 0;
+	for (uxx cIndex = 0; cIndex < name.length; cIndex++)
+	{
+		u8 character = NormalizeTrigramChar((u8)name.chars[cIndex]);
+		if (character == TRIGRAM_PAD_CHAR && (length == 0 || chars[length-1] == TRIGRAM_PAD_CHAR)) { continue; }
+		chars[length++] = character;
+	}
+	if (length > 0 && chars[length-1] == TRIGRAM_PAD_CHAR) { length--; }
+	return NewStr8(length, chars);
+}
+
+uxx GetTreeMergeNodeKey(Str8 normalizedName, TreeNodeType type)
+{
+	u64 keyInput[2] = { HashTreeBytes(normalizedName.chars, normalizedName.length), (u64)type };
+	uxx result = (uxx)HashTreeBytes(&keyInput[0], sizeof(keyInput));
+	return (result != ID_TABLE_EMPTY_KEY) ? result : 1;
+}
+uxx GetTreeMergeBranchKey(TreeBranchType type, uxx fromId, uxx toId)
+{
+	TreeBranch keyBranch = ZEROED;
+	keyBranch.type = type;
+	keyBranch.fromId = fromId;
+	keyBranch.toId = toId;
+	uxx result = (uxx)GetTreeBranchHashKey(&keyBranch);
+	return (result != ID_TABLE_EMPTY_KEY) ? result : 1;
+}
+
+// Every node in source is matched to the node in dest with the same normalized name and type (the first one, if dest has duplicates)
+// or added to dest with a new id when there isn't one. Matched nodes keep everything they had in dest, source only fills in what's missing.
+// Branches are then added with their fromId/toId remapped to the dest nodes, skipping any that are identical (same ends and type)
+// to a branch dest already has, or that an earlier source branch already added.
+// Dest nodes go into a hash table keyed by name and type (the build side) and source nodes are looked up in it (the probe side),
+// then the same for branches, so this is O(N + B) in the size of both trees rather than comparing every pair of nodes.
+// Nothing here needs the app, so it works for batch merges of whole files as well as in-app. If a journal is given the whole merge
+// is recorded as one undo group. The source tree is not changed
+void MergeSkillTrees(SkillTree* dest, SkillTree* source, TreeUndoJournal* journal, TreeMergeResult* resultOut)
+{
+	NotNull(dest);
+	NotNull(dest->arena);
+	NotNull(source);
+	Assert(dest != source);
+	TreeMergeResult result = ZEROED;
+	uxx numRejectedBefore = dest->numRejectedDependencies;
+	ScratchBegin1(scratch, dest->arena);
+	if (journal != nullptr) { BeginTreeUndoGroup(journal); }
+	BeginTreeEdit(dest, source->numNodes, source->numBranches);
+	
+	// Build: dest nodes by name and type
+	IdTable nodeKeys; //GetTreeMergeNodeKey -> dest node index
+	InitIdTable(scratch, &nodeKeys);
+	IdTableReserve(&nodeKeys, dest->numNodes + source->numNodes);
+	TreeNodeView destNodes = GetTreeNodesView(dest); //only used before we start adding nodes
+	for (uxx nIndex = 0; nIndex < destNodes.count; nIndex++)
+	{
+		TreeNode* node = &TreeViewAt(destNodes, nIndex);
+		if (!IsTreeSlotGenerationAlive(node->generation)) { continue; }
+		uxx key = GetTreeMergeNodeKey(NormalizeTreeMergeName(scratch, GetTreeNodeName(dest, node)), node->type);
+		if (!IdTableFind(&nodeKeys, key, nullptr)) { IdTableSet(&nodeKeys, key, nIndex); }
+	}
+	
+	// Probe: source nodes, adding the ones dest doesn't have. Added nodes go into the table too so duplicates within source collapse into one node
+	IdTable idRemap; //source node id -> dest node id
+	InitIdTable(scratch, &idRemap);
+	IdTableReserve(&idRemap, source->numNodes);
+	TreeNodeView sourceNodes = GetTreeNodesView(source);
+	for (uxx nIndex = 0; nIndex < sourceNodes.count; nIndex++)
+	{
+		TreeNode* sourceNode = &TreeViewAt(sourceNodes, nIndex);
+		if (!IsTreeSlotGenerationAlive(sourceNode->generation)) { continue; }
+		Str8 sourceName = GetTreeNodeName(source, sourceNode);
+		Str8 normalizedName = NormalizeTreeMergeName(scratch, sourceName);
+		uxx key = GetTreeMergeNodeKey(normalizedName, sourceNode->type);
+		uxx destIndex = 0;
+		bool keyTaken = IdTableFind(&nodeKeys, key, &destIndex);
+		if (keyTaken)
+		{
+			TreeNode* destNode = VarArrayGetHard(TreeNode, &dest->nodes, destIndex);
+			// Two different names sharing a 64-bit key is unlikely enough that we just don't merge them (the source node is added on its own)
+			if (destNode->type == sourceNode->type && StrExactEquals(NormalizeTreeMergeName(scratch, GetTreeNodeName(dest, destNode)), normalizedName))
+			{
+				IdTableSet(&idRemap, sourceNode->id, destNode->id);
+				result.numNodesMatched++;
+				continue;
+			}
+		}
+		
+		TreeNode* newNode = AddTreeNode(dest, sourceNode->type, sourceName, GetTreeNodePosition(source, sourceNode), GetTreeNodeColor(source, sourceNode));
+		if (!keyTaken) { IdTableSet(&nodeKeys, key, GetTreeNodeIndex(dest, newNode)); }
+		IdTableSet(&idRemap, sourceNode->id, newNode->id);
+		if (journal != nullptr) { RecordTreeNodeAdd(journal, dest, newNode); }
+		result.numNodesAdded++;
+	}
+	
+	// Build: dest branches by ends and type
+	IdTable branchKeys; //GetTreeMergeBranchKey -> dest branch index
+	InitIdTable(scratch, &branchKeys);
+	IdTableReserve(&branchKeys, dest->numBranches + source->numBranches);
+	TreeBranchView destBranches = GetTreeBranchesView(dest);
+	for (uxx bIndex = 0; bIndex < destBranches.count; bIndex++)
+	{
+		TreeBranch* branch = &TreeViewAt(destBranches, bIndex);
+		if (!IsTreeSlotGenerationAlive(branch->generation)) { continue; }
+		IdTableSet(&branchKeys, GetTreeMergeBranchKey(branch->type, branch->fromId, branch->toId), bIndex);
+	}
+	
+	// Probe: source branches with their ends remapped
+	VarArray addedBranches; //TreeBranchHandle
+	InitVarArray(TreeBranchHandle, &addedBranches, scratch);
+	TreeBranchView sourceBranches = GetTreeBranchesView(source);
+	for (uxx bIndex = 0; bIndex < sourceBranches.count; bIndex++)
+	{
+		TreeBranch* sourceBranch = &TreeViewAt(sourceBranches, bIndex);
+		if (!IsTreeSlotGenerationAlive(sourceBranch->generation)) { continue; }
+		uxx fromId = 0, toId = 0;
+		if (!IdTableFind(&idRemap, sourceBranch->fromId, &fromId) || !IdTableFind(&idRemap, sourceBranch->toId, &toId))
+		{
+			result.numBranchesDropped++;
+			continue;
+		}
+		
+		uxx key = GetTreeMergeBranchKey(sourceBranch->type, fromId, toId);
+		uxx destIndex = 0;
+		bool keyTaken = IdTableFind(&branchKeys, key, &destIndex);
+		if (keyTaken)
+		{
+			TreeBranch* destBranch = VarArrayGetHard(TreeBranch, &dest->branches, destIndex);
+			bool isIdentical = (destBranch->type == sourceBranch->type && destBranch->fromId == fromId && destBranch->toId == toId);
+			if (isIdentical || FindTreeBranch(dest, sourceBranch->type, fromId, toId) != nullptr)
+			{
+				result.numBranchesDeduplicated++;
+				continue;
+			}
+		}
+		
+		TreeBranch* newBranch = AddTreeBranch(dest, sourceBranch->type, GetTreeBranchName(source, sourceBranch), fromId, toId);
+		if (newBranch == nullptr) { continue; } //rejected, counted below
+		if (!keyTaken) { IdTableSet(&branchKeys, key, GetTreeBranchIndex(dest, newBranch)); }
+		*VarArrayAdd(TreeBranchHandle, &addedBranches) = GetTreeBranchHandle(dest, newBranch);
+	}
+	
+	CommitTreeEdit(dest);
+	// The commit can still reject Dependencies (when it had to rebake) so only the branches that survived it are counted and recorded
+	VarArrayLoop(&addedBranches, aIndex)
+	{
+		VarArrayLoopGet(TreeBranchHandle, branchHandle, &addedBranches, aIndex);
+		TreeBranch* branch = GetTreeBranchByHandle(dest, *branchHandle);
+		if (branch == nullptr) { continue; }
+		if (journal != nullptr) { RecordTreeBranchAdd(journal, branch); }
+		result.numBranchesAdded++;
+	}
+	result.numBranchesRejected = dest->numRejectedDependencies - numRejectedBefore;
+	if (journal != nullptr) { EndTreeUndoGroup(journal); }
+	
+	ScratchEnd(scratch);
+	SetOptionalOutPntr(resultOut, result);
+}
@@ -0,0 +1,22 @@
+/*
+File:   app_tree_merge.h
+Author: Taylor Robbins
+Date:   10\17\2026
+*/
+
+#ifndef _APP_TREE_MERGE_H
+#define _APP_TREE_MERGE_H
+
+// What MergeSkillTrees did to the destination tree, mostly so it can be reported back to the user
+typedef struct TreeMergeResult TreeMergeResult;
+struct TreeMergeResult
+{
+	uxx numNodesMatched; //source nodes that were folded into a node with the same (normalized) name and type
+	uxx numNodesAdded;
+	uxx numBranchesAdded;
+	uxx numBranchesDeduplicated; //source branches that (after remapping) were identical to a branch that was already there
+	uxx numBranchesDropped; //source branches with an end that isn't a node in the source tree
+	uxx numBranchesRejected; //Dependencies that would have closed a cycle (see SkillTree::rejectDependencyCycles)
+};
+
+#endif //  _APP_TREE_MERGE_H
@@ -0,0 +1,185 @@
+/*
+File:   app_tree_path.c
+Author: Taylor Robbins
+Date:   10\17\2026
+Description:
+	** Holds FindTreePath, an A* search over the baked references of a SkillTree
+	** that finds the cheapest route (a learning path) from one node to another
+*/
+
+TreePathCosts GetDefaultTreePathCosts()
+{
+	TreePathCosts result = ZEROED;
+	result.partitionCosts[GetTreeRefPartition(false, TreeBranchType_Dependency)] = TREE_PATH_COST_DEPENDENCY;
+	result.partitionCosts[GetTreeRefPartition(true, TreeBranchType_Dependency)] = TREE_PATH_COST_DEPENDENCY_BACKWARD;
+	result.partitionCosts[GetTreeRefPartition(false, TreeBranchType_Commonality)] = TREE_PATH_COST_COMMONALITY;
+	result.partitionCosts[GetTreeRefPartition(true, TreeBranchType_Commonality)] = TREE_PATH_COST_COMMONALITY;
+	result.partitionCosts[GetTreeRefPartition(false, TreeBranchType_Reference)] = TREE_PATH_COST_REFERENCE;
+	result.partitionCosts[GetTreeRefPartition(true, TreeBranchType_Reference)] = TREE_PATH_COST_REFERENCE;
+	return result;
+}
+
+void SiftUpTreePathHeap(TreePathSearch* search, uxx heapIndex)
+{
+	u32 nodeIndex = search->heap[heapIndex];
+	while (heapIndex > 0)
+	{
+		uxx parentIndex = (heapIndex - 1) / 2;
+		u32 parentNode = search->heap[parentIndex];
+		if (search->fScores[parentNode] <= search->fScores[nodeIndex]) { break; }
+		search->heap[heapIndex] = parentNode;
+		search->heapPositions[parentNode] = (u32)heapIndex;
+		heapIndex = parentIndex;
+	}
+	search->heap[heapIndex] = nodeIndex;
+	search->heapPositions[nodeIndex] = (u32)heapIndex;
+}
+void SiftDownTreePathHeap(TreePathSearch* search, uxx heapIndex)
+{
+	u32 nodeIndex = search->heap[heapIndex];
+	while (true)
+	{
+		uxx childIndex = heapIndex * 2 + 1;
+		if (childIndex >= search->heapLength) { break; }
+		if (childIndex + 1 < search->heapLength && search->fScores[search->heap[childIndex + 1]] < search->fScores[search->heap[childIndex]]) { childIndex++; }
+		u32 childNode = search->heap[childIndex];
+		if (search->fScores[nodeIndex] <= search->fScores[childNode]) { break; }
+		search->heap[heapIndex] = childNode;
+		search->heapPositions[childNode] = (u32)heapIndex;
+		heapIndex = childIndex;
+	}
+	search->heap[heapIndex] = nodeIndex;
+	search->heapPositions[nodeIndex] = (u32)heapIndex;
+}
+u32 PopTreePathHeap(TreePathSearch* search)
+{
+	Assert(search->heapLength > 0);
+	u32 result = search->heap[0];
+	search->heapLength--;
+	if (search->heapLength > 0)
+	{
+		search->heap[0] = search->heap[search->heapLength];
+		SiftDownTreePathHeap(search, 0);
+	}
+	search->heapPositions[result] = TREE_PATH_CLOSED;
+	return result;
+}
+
+// Finds the cheapest path between two nodes with A*, walking the baked references of each node (so the cost of a query only depends
+// on the part of the tree it explores). Each step costs the partition's cost times the distance between the nodes plus TREE_PATH_STEP_LENGTH,
+// and the heuristic is the straight line distance to the goal times the cheapest partition cost. By the triangle inequality no path can be
+// cheaper than that so the heuristic is admissible (and consistent, which is why expanded nodes never have to be reopened).
+// nodesOut gets the TreeNodeHandles from fromId to toId, branchesOut (optional, must use the same arena) the TreeBranchHandle between each pair.
+// Returns false with both arrays empty if either node doesn't exist or there's no path
+bool FindTreePath(SkillTree* tree, uxx fromId, uxx toId, const TreePathCosts* costs, VarArray* nodesOut, VarArray* branchesOut, r32* costOut)
+{
+	NotNull(tree);
+	NotNull(costs);
+	NotNull(nodesOut);
+	Assert(tree->referencesBaked);
+	Assert(branchesOut == nullptr || branchesOut->arena == nodesOut->arena);
+	VarArrayClear(nodesOut, false);
+	if (branchesOut != nullptr) { VarArrayClear(branchesOut, false); }
+	TreeNode* fromNode = GetTreeNodeById(tree, fromId);
+	TreeNode* toNode = GetTreeNodeById(tree, toId);
+	if (fromNode == nullptr || toNode == nullptr) { return false; }
+	u32 startIndex = (u32)GetTreeNodeIndex(tree, fromNode);
+	u32 goalIndex = (u32)GetTreeNodeIndex(tree, toNode);
+	r32 minCost = 0.0f;
+	for (uxx pIndex = 0; pIndex < TREE_REF_NUM_PARTITIONS; pIndex++)
+	{
+		r32 partitionCost = costs->partitionCosts[pIndex];
+		if (partitionCost > 0.0f && (minCost == 0.0f || partitionCost < minCost)) { minCost = partitionCost; }
+	}
+	ScratchBegin2(scratch, tree->arena, nodesOut->arena);
+	
+	uxx numSlots = tree->nodes.length;
+	TreePathSearch search = ZEROED;
+	search.heap = AllocArray(u32, scratch, numSlots);
+	search.heapPositions = AllocArray(u32, scratch, numSlots);
+	search.gScores = AllocArray(r32, scratch, numSlots);
+	search.fScores = AllocArray(r32, scratch, numSlots);
+	search.parentNodes = AllocArray(u32, scratch, numSlots);
+	search.parentBranches = AllocArray(u32, scratch, numSlots);
+	NotNull(search.heap);
+	NotNull(search.heapPositions);
+	NotNull(search.gScores);
+	NotNull(search.fScores);
+	NotNull(search.parentNodes);
+	NotNull(search.parentBranches);
+	MyMemSet(search.heapPositions, 0xFF, sizeof(u32) * numSlots); //TREE_INVALID_INDEX
+	
+	TreePositionView positions = GetTreeNodePositionsView(tree);
+	TreeNodeRefsView allNodeRefs = GetTreeNodeRefsView(tree);
+	TreeReferenceView refs = GetTreeReferencesView(tree);
+	v2 goalPosition = TreeViewAt(positions, goalIndex);
+	search.gScores[startIndex] = 0.0f;
+	search.fScores[startIndex] = minCost * Length(Sub(goalPosition, TreeViewAt(positions, startIndex)));
+	search.parentNodes[startIndex] = TREE_INVALID_INDEX;
+	search.parentBranches[startIndex] = TREE_INVALID_INDEX;
+	search.heap[0] = startIndex;
+	search.heapPositions[startIndex] = 0;
+	search.heapLength = 1;
+	bool foundGoal = false;
+	while (search.heapLength > 0)
+	{
+		u32 nodeIndex = PopTreePathHeap(&search);
+		if (nodeIndex == goalIndex) { foundGoal = true; break; }
+		v2 nodePosition = TreeViewAt(positions, nodeIndex);
+		const TreeNodeRefs* nodeRefs = &TreeViewAt(allNodeRefs, nodeIndex);
+		for (uxx pIndex = 0; pIndex < TREE_REF_NUM_PARTITIONS; pIndex++)
+		{
+			r32 partitionCost = costs->partitionCosts[pIndex];
+			if (partitionCost <= 0.0f) { continue; }
+			for (uxx rIndex = nodeRefs->partitionStarts[pIndex]; rIndex < nodeRefs->partitionStarts[pIndex+1]; rIndex++)
+			{
+				const TreeReference* reference = &TreeViewAt(refs, rIndex);
+				u32 nextIndex = reference->nodeIndex;
+				if (nextIndex == TREE_INVALID_INDEX || search.heapPositions[nextIndex] == TREE_PATH_CLOSED) { continue; }
+				v2 nextPosition = TreeViewAt(positions, nextIndex);
+				r32 gScore = search.gScores[nodeIndex] + partitionCost * (Length(Sub(nextPosition, nodePosition)) + TREE_PATH_STEP_LENGTH);
+				bool isNew = (search.heapPositions[nextIndex] == TREE_INVALID_INDEX);
+				if (!isNew && gScore >= search.gScores[nextIndex]) { continue; }
+				search.gScores[nextIndex] = gScore;
+				search.fScores[nextIndex] = gScore + minCost * Length(Sub(goalPosition, nextPosition));
+				search.parentNodes[nextIndex] = nodeIndex;
+				search.parentBranches[nextIndex] = reference->branchIndex;
+				if (isNew)
+				{
+					search.heap[search.heapLength] = nextIndex;
+					search.heapLength++;
+					SiftUpTreePathHeap(&search, search.heapLength-1);
+				}
+				else { SiftUpTreePathHeap(&search, search.heapPositions[nextIndex]); }
+			}
+		}
+	}
+	
+	if (foundGoal)
+	{
+		uxx numSteps = 0;
+		for (u32 nodeIndex = goalIndex; nodeIndex != startIndex; nodeIndex = search.parentNodes[nodeIndex]) { numSteps++; }
+		TreeNodeHandle* pathNodes = VarArrayAddMulti(TreeNodeHandle, nodesOut, numSteps + 1);
+		TreeBranchHandle* pathBranches = (branchesOut != nullptr && numSteps > 0) ? VarArrayAddMulti(TreeBranchHandle, branchesOut, numSteps) : nullptr;
+		TreeNodeView nodes = GetTreeNodesView(tree);
+		TreeBranchView branches = GetTreeBranchesView(tree);
+		u32 nodeIndex = goalIndex;
+		for (uxx sIndex = numSteps + 1; sIndex > 0; sIndex--)
+		{
+			pathNodes[sIndex-1].index = nodeIndex;
+			pathNodes[sIndex-1].generation = TreeViewAt(nodes, nodeIndex).generation;
+			if (sIndex == 1) { break; }
+			if (pathBranches != nullptr)
+			{
+				u32 branchIndex = search.parentBranches[nodeIndex];
+				pathBranches[sIndex-2].index = branchIndex;
+				pathBranches[sIndex-2].generation = TreeViewAt(branches, branchIndex).generation;
+			}
+			nodeIndex = search.parentNodes[nodeIndex];
+		}
+		SetOptionalOutPntr(costOut, search.gScores[goalIndex]);
+	}
+	
+	ScratchEnd(scratch);
+	return foundGoal;
+}
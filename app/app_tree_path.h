@@ -0,0 +1,42 @@
+/*
+File:   app_tree_path.h
+Author: Taylor Robbins
+Date:   10\17\2026
+*/
+
+#ifndef _APP_TREE_PATH_H
+#define _APP_TREE_PATH_H
+
+// What each step of a path costs per unit of distance between the two nodes, by the partition (branch type and direction) it walks.
+// Learning a dependent after its dependency is the cheapest step, going back to pick up a prerequisite costs more, and
+// hopping across a Commonality or Reference is somewhere in between. A cost of 0 means branches can't be walked that way
+#define TREE_PATH_COST_DEPENDENCY           1.0f
+#define TREE_PATH_COST_DEPENDENCY_BACKWARD  2.0f
+#define TREE_PATH_COST_COMMONALITY          1.5f
+#define TREE_PATH_COST_REFERENCE            3.0f
+// Added to the distance of every step so nodes sitting on top of each other don't make a long path look free (about the size of a node)
+#define TREE_PATH_STEP_LENGTH  32.0f //px
+// Marks a node in TreePathSearch::heapPositions that has been expanded (everything else is a position in the heap or TREE_INVALID_INDEX)
+#define TREE_PATH_CLOSED  (TREE_INVALID_INDEX - 1)
+
+typedef struct TreePathCosts TreePathCosts;
+struct TreePathCosts
+{
+	r32 partitionCosts[TREE_REF_NUM_PARTITIONS]; //indexed by GetTreeRefPartition
+};
+
+// The per-query state of FindTreePath, every array is indexed by node index and allocated once per query from a scratch arena.
+// Only heapPositions has to be cleared up front, the rest of a node's entries are written the first time the search reaches it
+typedef struct TreePathSearch TreePathSearch;
+struct TreePathSearch
+{
+	uxx heapLength;
+	u32* heap; //node indices, a binary min-heap ordered by fScores
+	u32* heapPositions; //where each node is in heap (TREE_INVALID_INDEX if it hasn't been reached, TREE_PATH_CLOSED once it's expanded)
+	r32* gScores; //cost of the best path to the node found so far
+	r32* fScores; //gScores plus the heuristic estimate of the rest of the way
+	u32* parentNodes;
+	u32* parentBranches;
+};
+
+#endif //  _APP_TREE_PATH_H
@@ -0,0 +1,291 @@
+/*
+File:   app_tree_reach.c
+Author: Taylor Robbins
+Date:   10\16\2026
+Description:
+	** Holds the TreeReachIndex which answers "is this node a prerequisite of that node"
+	** and "list every prerequisite of this node" without walking the Dependency branches per query
+*/
+
+void FreeTreeReachLabels(TreeReachLabels* labels)
+{
+	NotNull(labels);
+	FreeVarArray(&labels->nodeLabels);
+	FreeVarArray(&labels->labelNodes);
+	FreeVarArray(&labels->nodeSpans);
+	FreeVarArray(&labels->intervals);
+	ClearPointer(labels);
+}
+
+void InitTreeReachLabels(Arena* arena, bool isIncoming, TreeReachLabels* labelsOut)
+{
+	NotNull(arena);
+	NotNull(labelsOut);
+	ClearPointer(labelsOut);
+	labelsOut->isIncoming = isIncoming;
+	InitVarArray(u32, &labelsOut->nodeLabels, arena);
+	InitVarArray(u32, &labelsOut->labelNodes, arena);
+	InitVarArray(TreeReachSpan, &labelsOut->nodeSpans, arena);
+	InitVarArray(TreeReachInterval, &labelsOut->intervals, arena);
+}
+
+void FreeTreeReachIndex(TreeReachIndex* index)
+{
+	NotNull(index);
+	if (index->arena != nullptr)
+	{
+		FreeTreeReachLabels(&index->prerequisites);
+		FreeTreeReachLabels(&index->dependents);
+	}
+	ClearPointer(index);
+}
+
+void InitTreeReachIndex(Arena* arena, TreeReachIndex* indexOut)
+{
+	NotNull(arena);
+	NotNull(indexOut);
+	ClearPointer(indexOut);
+	indexOut->arena = arena;
+	InitTreeReachLabels(arena, true, &indexOut->prerequisites);
+	InitTreeReachLabels(arena, false, &indexOut->dependents);
+}
+
+// Both lists must be sorted, the output is sorted with overlapping/adjacent intervals combined
+uxx MergeTreeReachIntervals(const TreeReachInterval* left, uxx numLeft, const TreeReachInterval* right, uxx numRight, TreeReachInterval* output)
+{
+	uxx numOutput = 0;
+	uxx lIndex = 0;
+	uxx rIndex = 0;
+	while (lIndex < numLeft || rIndex < numRight)
+	{
+		TreeReachInterval next;
+		if (rIndex >= numRight || (lIndex < numLeft && left[lIndex].min <= right[rIndex].min)) { next = left[lIndex++]; }
+		else { next = right[rIndex++]; }
+		TreeReachInterval* prev = (numOutput > 0) ? &output[numOutput-1] : nullptr;
+		if (prev != nullptr && next.min <= prev->max + 1) { if (next.max > prev->max) { prev->max = next.max; } }
+		else { output[numOutput++] = next; }
+	}
+	return numOutput;
+}
+
+// topoOrder is the u32 node indices from GetTreeTopologicalOrder (every node comes after its dependencies)
+void BuildTreeReachLabels(TreeReachLabels* labels, SkillTree* tree, const VarArray* topoOrder)
+{
+	NotNull(labels);
+	NotNull(tree);
+	NotNull(topoOrder);
+	uxx numNodeSlots = tree->nodes.length;
+	uxx numOrdered = topoOrder->length;
+	const u32* order = (const u32*)topoOrder->items;
+	const u32* tiers = (const u32*)tree->nodeTiers.items;
+	TreeReferenceView references = GetTreeReferencesView(tree);
+	// "Forward" is the direction we are finding reachable nodes in, for prerequisites that's walking incoming Dependency branches
+	uxx forwardPartition = GetTreeRefPartition(labels->isIncoming, TreeBranchType_Dependency);
+	uxx backwardPartition = GetTreeRefPartition(!labels->isIncoming, TreeBranchType_Dependency);
+	
+	VarArrayClear(&labels->nodeLabels, false);
+	VarArrayClear(&labels->labelNodes, false);
+	VarArrayClear(&labels->nodeSpans, false);
+	VarArrayClear(&labels->intervals, false);
+	if (numNodeSlots == 0) { return; }
+	u32* nodeLabels = VarArrayAddMulti(u32, &labels->nodeLabels, numNodeSlots);
+	MyMemSet(nodeLabels, 0xFF, sizeof(u32) * numNodeSlots); //TREE_INVALID_INDEX
+	TreeReachSpan* nodeSpans = VarArrayAddMulti(TreeReachSpan, &labels->nodeSpans, numNodeSlots);
+	MyMemSet(nodeSpans, 0x00, sizeof(TreeReachSpan) * numNodeSlots);
+	if (numOrdered == 0) { return; }
+	u32* labelNodes = VarArrayAddMulti(u32, &labels->labelNodes, numOrdered);
+	ScratchBegin1(scratch, tree->arena);
+	
+	// Every node picks one node that reaches it in a single step as its parent in the spanning forest
+	u32* treeParents = AllocArray(u32, scratch, numNodeSlots);
+	u32* childStarts = AllocArray(u32, scratch, numNodeSlots + 1);
+	MyMemSet(childStarts, 0x00, sizeof(u32) * (numNodeSlots + 1));
+	for (uxx oIndex = 0; oIndex < numOrdered; oIndex++)
+	{
+		u32 nodeIndex = order[oIndex];
+		const TreeNodeRefs* nodeRefs = GetTreeNodeRefs(tree, nodeIndex);
+		treeParents[nodeIndex] = TREE_INVALID_INDEX;
+		for (uxx rIndex = nodeRefs->partitionStarts[backwardPartition]; rIndex < nodeRefs->partitionStarts[backwardPartition+1]; rIndex++)
+		{
+			u32 otherIndex = TreeViewAt(references, rIndex).nodeIndex;
+			if (otherIndex == TREE_INVALID_INDEX || otherIndex == nodeIndex || tiers[otherIndex] == TREE_INVALID_TIER) { continue; }
+			treeParents[nodeIndex] = otherIndex;
+			childStarts[otherIndex + 1]++;
+			break;
+		}
+	}
+	for (uxx nIndex = 1; nIndex <= numNodeSlots; nIndex++) { childStarts[nIndex] += childStarts[nIndex-1]; }
+	u32* childCursors = AllocArray(u32, scratch, numNodeSlots);
+	MyMemCopy(childCursors, childStarts, sizeof(u32) * numNodeSlots);
+	u32* children = AllocArray(u32, scratch, numOrdered);
+	for (uxx oIndex = 0; oIndex < numOrdered; oIndex++)
+	{
+		u32 nodeIndex = order[oIndex];
+		if (treeParents[nodeIndex] != TREE_INVALID_INDEX) { children[childCursors[treeParents[nodeIndex]]++] = nodeIndex; }
+	}
+	
+	// Post-order walk of the forest. Everything under a node gets labels in [subtreeMins[node], nodeLabels[node]]
+	u32* subtreeMins = AllocArray(u32, scratch, numNodeSlots);
+	u32* stackNodes = AllocArray(u32, scratch, numOrdered);
+	u32* stackCursors = AllocArray(u32, scratch, numOrdered);
+	u32 nextLabel = 0;
+	for (uxx oIndex = 0; oIndex < numOrdered; oIndex++)
+	{
+		u32 rootIndex = order[oIndex];
+		if (treeParents[rootIndex] != TREE_INVALID_INDEX) { continue; }
+		uxx stackDepth = 1;
+		stackNodes[0] = rootIndex;
+		stackCursors[0] = childStarts[rootIndex];
+		subtreeMins[rootIndex] = nextLabel;
+		while (stackDepth > 0)
+		{
+			u32 topIndex = stackNodes[stackDepth-1];
+			if (stackCursors[stackDepth-1] < childStarts[topIndex+1])
+			{
+				u32 childIndex = children[stackCursors[stackDepth-1]++];
+				subtreeMins[childIndex] = nextLabel;
+				stackNodes[stackDepth] = childIndex;
+				stackCursors[stackDepth] = childStarts[childIndex];
+				stackDepth++;
+			}
+			else
+			{
+				nodeLabels[topIndex] = nextLabel;
+				labelNodes[nextLabel] = topIndex;
+				nextLabel++;
+				stackDepth--;
+			}
+		}
+	}
+	Assert(nextLabel == numOrdered);
+	
+	// Visit nodes so everything they reach in one step is done before them, and merge their intervals into ours
+	TreeReachInterval* mergeBuffers[2];
+	mergeBuffers[0] = AllocArray(TreeReachInterval, scratch, numOrdered);
+	mergeBuffers[1] = AllocArray(TreeReachInterval, scratch, numOrdered);
+	for (uxx oIndex = 0; oIndex < numOrdered; oIndex++)
+	{
+		u32 nodeIndex = order[labels->isIncoming ? oIndex : (numOrdered-1 - oIndex)];
+		TreeReachInterval* merged = mergeBuffers[0];
+		merged[0].min = subtreeMins[nodeIndex];
+		merged[0].max = nodeLabels[nodeIndex];
+		uxx numMerged = 1;
+		const TreeNodeRefs* nodeRefs = GetTreeNodeRefs(tree, nodeIndex);
+		for (uxx rIndex = nodeRefs->partitionStarts[forwardPartition]; rIndex < nodeRefs->partitionStarts[forwardPartition+1]; rIndex++)
+		{
+			u32 otherIndex = TreeViewAt(references, rIndex).nodeIndex;
+			if (otherIndex == TREE_INVALID_INDEX || nodeLabels[otherIndex] == TREE_INVALID_INDEX) { continue; }
+			if (treeParents[otherIndex] == nodeIndex && nodeSpans[otherIndex].count == 1) { continue; } //a tree child with no extra intervals is already covered by our subtree
+			const TreeReachSpan* otherSpan = &nodeSpans[otherIndex];
+			const TreeReachInterval* otherIntervals = VarArrayGetHard(TreeReachInterval, &labels->intervals, otherSpan->start);
+			TreeReachInterval* output = (merged == mergeBuffers[0]) ? mergeBuffers[1] : mergeBuffers[0];
+			numMerged = MergeTreeReachIntervals(merged, numMerged, otherIntervals, otherSpan->count, output);
+			merged = output;
+		}
+		nodeSpans[nodeIndex].start = (u32)labels->intervals.length;
+		nodeSpans[nodeIndex].count = (u32)numMerged;
+		TreeReachInterval* newIntervals = VarArrayAddMulti(TreeReachInterval, &labels->intervals, numMerged);
+		MyMemCopy(newIntervals, merged, sizeof(TreeReachInterval) * numMerged);
+	}
+	
+	ScratchEnd(scratch);
+}
+
+// True if the next query won't have to rebuild the index first
+bool IsTreeReachIndexCurrent(const TreeReachIndex* index, const SkillTree* tree)
+{
+	NotNull(index);
+	NotNull(tree);
+	return (index->isBuilt && index->builtVersion == tree->dependencyVersion);
+}
+
+void UpdateTreeReachIndex(TreeReachIndex* index, SkillTree* tree)
+{
+	NotNull(index);
+	NotNull(index->arena);
+	NotNull(tree);
+	Assert(tree->referencesBaked);
+	if (IsTreeReachIndexCurrent(index, tree)) { return; }
+	const VarArray* topoOrder = GetTreeTopologicalOrder(tree);
+	BuildTreeReachLabels(&index->prerequisites, tree, topoOrder);
+	BuildTreeReachLabels(&index->dependents, tree, topoOrder);
+	index->isBuilt = true;
+	index->builtVersion = tree->dependencyVersion;
+}
+
+bool IsTreeReachLabelInSpan(TreeReachLabels* labels, uxx nodeIndex, u32 label)
+{
+	const TreeReachSpan* span = VarArrayGetHard(TreeReachSpan, &labels->nodeSpans, nodeIndex);
+	if (span->count == 0) { return false; }
+	const TreeReachInterval* intervals = VarArrayGetHard(TreeReachInterval, &labels->intervals, span->start);
+	// Find the last interval that starts at or before the label
+	uxx low = 0;
+	uxx high = span->count;
+	while (low < high)
+	{
+		uxx middle = (low + high) / 2;
+		if (intervals[middle].min <= label) { low = middle + 1; }
+		else { high = middle; }
+	}
+	return (low > 0 && intervals[low-1].max >= label);
+}
+
+// Returns true if prerequisite has to be learned (directly or indirectly) before node. A node is not a prerequisite of itself
+bool IsTreeNodePrerequisite(TreeReachIndex* index, SkillTree* tree, const TreeNode* prerequisite, const TreeNode* node)
+{
+	NotNull(prerequisite);
+	NotNull(node);
+	UpdateTreeReachIndex(index, tree);
+	uxx prerequisiteIndex = GetTreeNodeIndex(tree, prerequisite);
+	uxx nodeIndex = GetTreeNodeIndex(tree, node);
+	if (prerequisiteIndex == nodeIndex) { return false; }
+	u32 nodeLabel = *VarArrayGetHard(u32, &index->dependents.nodeLabels, nodeIndex);
+	if (nodeLabel == TREE_INVALID_INDEX) { return false; }
+	return IsTreeReachLabelInSpan(&index->dependents, prerequisiteIndex, nodeLabel);
+}
+
+// Appends the u32 node index of everything reachable from nodeIndex (not including itself), returns how many were added
+uxx AppendTreeReachNodes(TreeReachLabels* labels, uxx nodeIndex, VarArray* nodeIndicesOut)
+{
+	const TreeReachSpan* span = VarArrayGetHard(TreeReachSpan, &labels->nodeSpans, nodeIndex);
+	if (span->count == 0) { return 0; }
+	const u32* labelNodes = (const u32*)labels->labelNodes.items;
+	uxx numReachable = 0;
+	for (uxx iIndex = 0; iIndex < span->count; iIndex++)
+	{
+		const TreeReachInterval* interval = VarArrayGetHard(TreeReachInterval, &labels->intervals, span->start + iIndex);
+		numReachable += (uxx)(interval->max - interval->min) + 1;
+	}
+	numReachable--; //the node's own label is always in one of the intervals
+	if (numReachable == 0) { return 0; }
+	u32* newIndices = VarArrayAddMulti(u32, nodeIndicesOut, numReachable);
+	uxx writeIndex = 0;
+	for (uxx iIndex = 0; iIndex < span->count; iIndex++)
+	{
+		const TreeReachInterval* interval = VarArrayGetHard(TreeReachInterval, &labels->intervals, span->start + iIndex);
+		for (u32 label = interval->min; label <= interval->max; label++)
+		{
+			if (labelNodes[label] != nodeIndex) { newIndices[writeIndex++] = labelNodes[label]; }
+		}
+	}
+	Assert(writeIndex == numReachable);
+	return numReachable;
+}
+
+// Appends the u32 node index of every node that has to be learned before node (directly or indirectly) to nodeIndicesOut
+uxx FindTreeNodePrerequisites(TreeReachIndex* index, SkillTree* tree, const TreeNode* node, VarArray* nodeIndicesOut)
+{
+	NotNull(node);
+	NotNull(nodeIndicesOut);
+	UpdateTreeReachIndex(index, tree);
+	return AppendTreeReachNodes(&index->prerequisites, GetTreeNodeIndex(tree, node), nodeIndicesOut);
+}
+
+// Appends the u32 node index of every node that depends on node (directly or indirectly) to nodeIndicesOut
+uxx FindTreeNodeDependents(TreeReachIndex* index, SkillTree* tree, const TreeNode* node, VarArray* nodeIndicesOut)
+{
+	NotNull(node);
+	NotNull(nodeIndicesOut);
+	UpdateTreeReachIndex(index, tree);
+	return AppendTreeReachNodes(&index->dependents, GetTreeNodeIndex(tree, node), nodeIndicesOut);
+}
@@ -0,0 +1,54 @@
+/*
+File:   app_tree_reach.h
+Author: Taylor Robbins
+Date:   10\16\2026
+*/
+
+#ifndef _APP_TREE_REACH_H
+#define _APP_TREE_REACH_H
+
+// An inclusive range of labels
+typedef struct TreeReachInterval TreeReachInterval;
+struct TreeReachInterval
+{
+	u32 min;
+	u32 max;
+};
+
+// A range of TreeReachLabels::intervals
+typedef struct TreeReachSpan TreeReachSpan;
+struct TreeReachSpan
+{
+	u32 start;
+	u32 count;
+};
+
+// Each node gets a label (its post-order number in a spanning forest of the Dependency graph) so that the nodes
+// under it in the forest have a contiguous range of labels. The full set of nodes reachable from a node is then
+// a short sorted list of disjoint intervals: the node's own subtree range plus whatever its non-tree branches add.
+// That's O(log intervals) to check a single node and proportional to the result to list them all
+typedef struct TreeReachLabels TreeReachLabels;
+struct TreeReachLabels
+{
+	bool isIncoming; //true: reachable means "is a prerequisite of", false: reachable means "depends on"
+	VarArray nodeLabels; //u32 (indexed by node index, TREE_INVALID_INDEX for free slots and nodes in a dependency cycle)
+	VarArray labelNodes; //u32 (label -> node index)
+	VarArray nodeSpans; //TreeReachSpan (indexed by node index)
+	VarArray intervals; //TreeReachInterval
+};
+
+// Answers "is A a prerequisite of B" and "what are all the prerequisites/dependents of X" for the
+// Dependency branches in a baked SkillTree. The index is rebuilt in O(N + B + intervals) the first time
+// it's queried after the tree's dependencyVersion changes, after that every query only reads the labels.
+// Nodes in a Dependency cycle don't get labels so they are never reported as prerequisites (or dependents) of anything
+typedef struct TreeReachIndex TreeReachIndex;
+struct TreeReachIndex
+{
+	Arena* arena;
+	bool isBuilt;
+	u64 builtVersion; //SkillTree::dependencyVersion when we last built
+	TreeReachLabels prerequisites;
+	TreeReachLabels dependents;
+};
+
+#endif //  _APP_TREE_REACH_H
@@ -0,0 +1,276 @@
+/*
+File:   app_tree_similar.c
+Author: Taylor Robbins
+Date:   10\17\2026
+Description:
+	** Holds the TreeSimilarIndex which finds Project nodes with similar
+	** dependencies using MinHash signatures and locality-sensitive hashing
+*/
+
+void FreeTreeSimilarIndex(TreeSimilarIndex* index)
+{
+	NotNull(index);
+	if (index->arena != nullptr)
+	{
+		VarArrayLoop(&index->buckets, bIndex)
+		{
+			VarArrayLoopGet(VarArray, bucket, &index->buckets, bIndex);
+			FreeVarArray(bucket);
+		}
+		FreeVarArray(&index->buckets);
+		FreeVarArray(&index->freeBuckets);
+		FreeIdTable(&index->bucketLookup);
+		FreeVarArray(&index->nodeSignatures);
+		FreeVarArray(&index->signatures);
+		FreeVarArray(&index->freeSignatures);
+		FreeVarArray(&index->candidateMarks);
+	}
+	ClearPointer(index);
+}
+
+void InitTreeSimilarIndex(Arena* arena, TreeSimilarIndex* indexOut)
+{
+	NotNull(arena);
+	NotNull(indexOut);
+	ClearPointer(indexOut);
+	indexOut->arena = arena;
+	InitVarArray(u32, &indexOut->nodeSignatures, arena);
+	InitVarArray(TreeSimilarSignature, &indexOut->signatures, arena);
+	InitVarArray(u32, &indexOut->freeSignatures, arena);
+	InitIdTable(arena, &indexOut->bucketLookup);
+	InitVarArray(VarArray, &indexOut->buckets, arena);
+	InitVarArray(u32, &indexOut->freeBuckets, arena);
+	InitVarArray(u32, &indexOut->candidateMarks, arena);
+}
+
+// The splitmix64 finalizer, every bit of the input affects every bit of the output
+u64 MixTreeSimilarHash(u64 value)
+{
+	value ^= (value >> 30);
+	value *= 0xBF58476D1CE4E5B9ULL;
+	value ^= (value >> 27);
+	value *= 0x94D049BB133111EBULL;
+	value ^= (value >> 31);
+	return value;
+}
+
+// Hash function hIndex of the signature, applied to a dependency id. Each one gets its own odd multiple of the golden ratio
+// added in before mixing, which is plenty to make them behave like independent permutations for sets of this size
+u32 GetTreeSimilarMinHash(u64 idHash, uxx hIndex)
+{
+	return (u32)(MixTreeSimilarHash(idHash + (2*hIndex + 1) * 0x9E3779B97F4A7C15ULL) >> 32);
+}
+
+VarArray* GetTreeSimilarBucket(TreeSimilarIndex* index, uxx bandKey, bool create)
+{
+	uxx bucketIndex = 0;
+	if (IdTableFind(&index->bucketLookup, bandKey, &bucketIndex)) { return VarArrayGetHard(VarArray, &index->buckets, bucketIndex); }
+	if (!create) { return nullptr; }
+	if (index->freeBuckets.length > 0)
+	{
+		bucketIndex = *VarArrayGetLast(u32, &index->freeBuckets);
+		VarArrayRemoveAt(u32, &index->freeBuckets, index->freeBuckets.length-1);
+	}
+	else
+	{
+		bucketIndex = index->buckets.length;
+		InitVarArray(u32, VarArrayAdd(VarArray, &index->buckets), index->arena);
+	}
+	IdTableSet(&index->bucketLookup, bandKey, bucketIndex);
+	return VarArrayGetHard(VarArray, &index->buckets, bucketIndex);
+}
+
+void RemoveTreeSimilarSignature(TreeSimilarIndex* index, u32 signatureIndex)
+{
+	TreeSimilarSignature* signature = VarArrayGetHard(TreeSimilarSignature, &index->signatures, signatureIndex);
+	Assert(signature->nodeId != 0);
+	for (uxx bIndex = 0; bIndex < TREE_SIMILAR_NUM_BANDS; bIndex++)
+	{
+		uxx bucketIndex = 0;
+		if (!IdTableFind(&index->bucketLookup, signature->bandKeys[bIndex], &bucketIndex)) { Assert(false); continue; }
+		VarArray* bucket = VarArrayGetHard(VarArray, &index->buckets, bucketIndex);
+		u32* items = (u32*)bucket->items;
+		// Two bands of the same signature can land in the same bucket, in which case the second pass finds nothing (like repeated trigrams)
+		for (uxx iIndex = bucket->length; iIndex > 0; iIndex--)
+		{
+			if (items[iIndex-1] != signatureIndex) { continue; }
+			items[iIndex-1] = items[bucket->length-1];
+			VarArrayRemoveAt(u32, bucket, bucket->length-1);
+			break;
+		}
+		if (bucket->length == 0)
+		{
+			IdTableRemove(&index->bucketLookup, signature->bandKeys[bIndex]);
+			*VarArrayAdd(u32, &index->freeBuckets) = (u32)bucketIndex;
+		}
+	}
+	*VarArrayGetHard(u32, &index->nodeSignatures, signature->nodeIndex) = TREE_INVALID_INDEX;
+	ClearPointer(signature);
+	*VarArrayAdd(u32, &index->freeSignatures) = signatureIndex;
+	index->numSignatures--;
+}
+
+// Brings the signature of one node slot up to date with its references, which must be baked
+void UpdateTreeSimilarNode(TreeSimilarIndex* index, SkillTree* tree, uxx nodeIndex)
+{
+	while (index->nodeSignatures.length <= nodeIndex) { *VarArrayAdd(u32, &index->nodeSignatures) = TREE_INVALID_INDEX; }
+	u32* nodeSignature = VarArrayGetHard(u32, &index->nodeSignatures, nodeIndex);
+	TreeNode* node = VarArrayGetHard(TreeNode, &tree->nodes, nodeIndex);
+	bool wantsSignature = (tree->referencesBaked && IsTreeSlotGenerationAlive(node->generation) && node->type == TreeNodeType_Project);
+	
+	const TreeReference* dependencies = nullptr;
+	uxx numReferences = 0;
+	u64 setHash = 0;
+	u32 numDependencies = 0;
+	if (wantsSignature)
+	{
+		const TreeNodeRefs* nodeRefs = GetTreeNodeRefs(tree, nodeIndex);
+		uxx partition = GetTreeRefPartition(true, TreeBranchType_Dependency);
+		dependencies = (const TreeReference*)tree->references.items + nodeRefs->partitionStarts[partition];
+		numReferences = nodeRefs->partitionStarts[partition+1] - nodeRefs->partitionStarts[partition];
+		for (uxx rIndex = 0; rIndex < numReferences; rIndex++)
+		{
+			if (dependencies[rIndex].nodeIndex == TREE_INVALID_INDEX) { continue; }
+			setHash += MixTreeSimilarHash(*VarArrayGetHard(uxx, &tree->nodeIds, dependencies[rIndex].nodeIndex)); //a sum doesn't care about order
+			numDependencies++;
+		}
+		if (numDependencies == 0) { wantsSignature = false; }
+	}
+	
+	if (*nodeSignature != TREE_INVALID_INDEX)
+	{
+		const TreeSimilarSignature* oldSignature = VarArrayGetHard(TreeSimilarSignature, &index->signatures, *nodeSignature);
+		if (wantsSignature && oldSignature->nodeId == node->id && oldSignature->numDependencies == numDependencies && oldSignature->setHash == setHash) { return; }
+		RemoveTreeSimilarSignature(index, *nodeSignature);
+	}
+	if (!wantsSignature) { return; }
+	
+	u32 signatureIndex = 0;
+	if (index->freeSignatures.length > 0)
+	{
+		signatureIndex = *VarArrayGetLast(u32, &index->freeSignatures);
+		VarArrayRemoveAt(u32, &index->freeSignatures, index->freeSignatures.length-1);
+	}
+	else
+	{
+		signatureIndex = (u32)index->signatures.length;
+		VarArrayAdd(TreeSimilarSignature, &index->signatures);
+		*VarArrayAdd(u32, &index->candidateMarks) = 0;
+	}
+	TreeSimilarSignature* signature = VarArrayGetHard(TreeSimilarSignature, &index->signatures, signatureIndex);
+	ClearPointer(signature);
+	signature->nodeId = node->id;
+	signature->nodeIndex = (u32)nodeIndex;
+	signature->numDependencies = numDependencies;
+	signature->setHash = setHash;
+	MyMemSet(&signature->minHashes[0], 0xFF, sizeof(signature->minHashes));
+	for (uxx rIndex = 0; rIndex < numReferences; rIndex++)
+	{
+		if (dependencies[rIndex].nodeIndex == TREE_INVALID_INDEX) { continue; }
+		u64 idHash = MixTreeSimilarHash(*VarArrayGetHard(uxx, &tree->nodeIds, dependencies[rIndex].nodeIndex));
+		for (uxx hIndex = 0; hIndex < TREE_SIMILAR_NUM_HASHES; hIndex++)
+		{
+			u32 minHash = GetTreeSimilarMinHash(idHash, hIndex);
+			if (minHash < signature->minHashes[hIndex]) { signature->minHashes[hIndex] = minHash; }
+		}
+	}
+	for (uxx bIndex = 0; bIndex < TREE_SIMILAR_NUM_BANDS; bIndex++)
+	{
+		// The band index goes into the key so equal rows in different bands don't share a bucket
+		u64 keyInput[2] = { HashTreeBytes(&signature->minHashes[bIndex * TREE_SIMILAR_BAND_ROWS], sizeof(u32) * TREE_SIMILAR_BAND_ROWS), (u64)bIndex };
+		uxx bandKey = (uxx)HashTreeBytes(&keyInput[0], sizeof(keyInput));
+		if (bandKey == ID_TABLE_EMPTY_KEY) { bandKey = 1; }
+		signature->bandKeys[bIndex] = bandKey;
+		VarArray* bucket = GetTreeSimilarBucket(index, bandKey, true);
+		if (bucket->length > 0 && *VarArrayGetLast(u32, bucket) == signatureIndex) { continue; }
+		*VarArrayAdd(u32, bucket) = signatureIndex;
+	}
+	*nodeSignature = signatureIndex;
+	index->numSignatures++;
+}
+
+// Cheap to call every frame, it returns right away unless some node's references changed since the last call
+void UpdateTreeSimilarIndex(TreeSimilarIndex* index, SkillTree* tree)
+{
+	NotNull(index);
+	NotNull(index->arena);
+	NotNull(tree);
+	if (index->builtRefsVersion == tree->refsVersion) { return; }
+	
+	for (uxx pIndex = 0; pIndex < tree->nodeRefPageVersions.length; pIndex++)
+	{
+		if (*VarArrayGetHard(u64, &tree->nodeRefPageVersions, pIndex) <= index->builtRefsVersion) { continue; }
+		uxx pageEnd = (pIndex+1) * TREE_SNAPSHOT_PAGE_SIZE;
+		if (pageEnd > tree->nodes.length) { pageEnd = tree->nodes.length; }
+		for (uxx nIndex = pIndex * TREE_SNAPSHOT_PAGE_SIZE; nIndex < pageEnd; nIndex++) { UpdateTreeSimilarNode(index, tree, nIndex); }
+	}
+	
+	index->builtRefsVersion = tree->refsVersion;
+}
+
+bool IsTreeSimilarMatchBetter(const TreeSimilarMatch* left, const TreeSimilarMatch* right)
+{
+	if (left->similarity != right->similarity) { return (left->similarity > right->similarity); }
+	return (left->node.index < right->node.index);
+}
+
+// Fills matchesOut with the (up to) maxMatches Project nodes whose dependencies are most like node's, most similar first, and returns
+// how many were found. Only projects that share at least one bucket with node are considered (see TREE_SIMILAR_NUM_BANDS) so a
+// project that has little in common with node might not be returned even if there's room for it
+uxx FindSimilarTreeNodes(TreeSimilarIndex* index, SkillTree* tree, const TreeNode* node, uxx maxMatches, TreeSimilarMatch* matchesOut)
+{
+	NotNull(index);
+	NotNull(tree);
+	NotNull(node);
+	Assert(matchesOut != nullptr || maxMatches == 0);
+	UpdateTreeSimilarIndex(index, tree);
+	uxx nodeIndex = GetTreeNodeIndex(tree, node);
+	if (maxMatches == 0 || nodeIndex >= index->nodeSignatures.length) { return 0; }
+	u32 querySignatureIndex = *VarArrayGetHard(u32, &index->nodeSignatures, nodeIndex);
+	if (querySignatureIndex == TREE_INVALID_INDEX) { return 0; }
+	const TreeSimilarSignature* querySignature = VarArrayGetHard(TreeSimilarSignature, &index->signatures, querySignatureIndex);
+	
+	// Marks are stamped rather than cleared, so we only have to wipe them when the stamp wraps around
+	index->candidateStamp++;
+	if (index->candidateStamp == 0)
+	{
+		MyMemSet(index->candidateMarks.items, 0x00, sizeof(u32) * index->candidateMarks.length);
+		index->candidateStamp = 1;
+	}
+	u32* candidateMarks = (u32*)index->candidateMarks.items;
+	candidateMarks[querySignatureIndex] = index->candidateStamp;
+	
+	uxx numMatches = 0;
+	for (uxx bIndex = 0; bIndex < TREE_SIMILAR_NUM_BANDS; bIndex++)
+	{
+		VarArray* bucket = GetTreeSimilarBucket(index, querySignature->bandKeys[bIndex], false);
+		NotNull(bucket);
+		const u32* items = (const u32*)bucket->items;
+		for (uxx iIndex = 0; iIndex < bucket->length; iIndex++)
+		{
+			u32 signatureIndex = items[iIndex];
+			if (candidateMarks[signatureIndex] == index->candidateStamp) { continue; }
+			candidateMarks[signatureIndex] = index->candidateStamp;
+			
+			const TreeSimilarSignature* signature = VarArrayGetHard(TreeSimilarSignature, &index->signatures, signatureIndex);
+			uxx numEqual = 0;
+			for (uxx hIndex = 0; hIndex < TREE_SIMILAR_NUM_HASHES; hIndex++) { if (signature->minHashes[hIndex] == querySignature->minHashes[hIndex]) { numEqual++; } }
+			TreeSimilarMatch match = ZEROED;
+			match.node.index = signature->nodeIndex;
+			match.node.generation = VarArrayGetHard(TreeNode, &tree->nodes, signature->nodeIndex)->generation;
+			match.similarity = (r32)numEqual / (r32)TREE_SIMILAR_NUM_HASHES;
+			if (numMatches == maxMatches && !IsTreeSimilarMatchBetter(&match, &matchesOut[numMatches-1])) { continue; }
+			
+			uxx insertIndex = (numMatches < maxMatches) ? numMatches : maxMatches-1;
+			while (insertIndex > 0 && IsTreeSimilarMatchBetter(&match, &matchesOut[insertIndex-1]))
+			{
+				matchesOut[insertIndex] = matchesOut[insertIndex-1];
+				insertIndex--;
+			}
+			matchesOut[insertIndex] = match;
+			if (numMatches < maxMatches) { numMatches++; }
+		}
+	}
+	
+	return numMatches;
+}
@@ -0,0 +1,56 @@
+/*
+File:   app_tree_similar.h
+Author: Taylor Robbins
+Date:   10\17\2026
+*/
+
+#ifndef _APP_TREE_SIMILAR_H
+#define _APP_TREE_SIMILAR_H
+
+// Each signature is TREE_SIMILAR_NUM_BANDS bands of TREE_SIMILAR_BAND_ROWS min-hashes. Two projects whose dependency sets have a
+// Jaccard similarity of s share at least one band (and so become candidates for each other) with probability 1-(1-s^4)^16:
+// about 12% at s=0.3, 64% at s=0.5, 99% at s=0.7. More rows per band filters out more of the dissimilar pairs, more bands finds more of the similar ones
+#define TREE_SIMILAR_NUM_BANDS   16
+#define TREE_SIMILAR_BAND_ROWS   4
+#define TREE_SIMILAR_NUM_HASHES  (TREE_SIMILAR_NUM_BANDS * TREE_SIMILAR_BAND_ROWS)
+
+typedef struct TreeSimilarSignature TreeSimilarSignature;
+struct TreeSimilarSignature
+{
+	uxx nodeId; //0 for free slots
+	u32 nodeIndex;
+	u32 numDependencies;
+	u64 setHash; //order independent hash of the dependency ids, only used to tell if the set changed
+	u32 minHashes[TREE_SIMILAR_NUM_HASHES];
+	uxx bandKeys[TREE_SIMILAR_NUM_BANDS]; //the bucket key of each band (never ID_TABLE_EMPTY_KEY)
+};
+
+typedef struct TreeSimilarMatch TreeSimilarMatch;
+struct TreeSimilarMatch
+{
+	TreeNodeHandle node;
+	r32 similarity; //estimated Jaccard similarity of the two dependency sets (the fraction of min-hashes that are equal)
+};
+
+// Finds Project nodes that depend on mostly the same things with MinHash locality-sensitive hashing. Every Project with at least
+// one Dependency gets a signature of min-hashes over the ids of its dependencies, and each band of the signature is a key into a
+// bucket of signatures. Only signatures that share a bucket with the query are compared, so a query costs the size of those
+// buckets rather than the number of projects. The index follows SkillTree::refsVersion and only revisits the pages of nodes whose
+// references changed, and a node whose dependency set didn't actually change keeps its signature (and its place in the buckets)
+typedef struct TreeSimilarIndex TreeSimilarIndex;
+struct TreeSimilarIndex
+{
+	Arena* arena;
+	u64 builtRefsVersion; //SkillTree::refsVersion the last time we caught up
+	uxx numSignatures;
+	VarArray nodeSignatures; //u32 (by node index, index into signatures or TREE_INVALID_INDEX)
+	VarArray signatures; //TreeSimilarSignature
+	VarArray freeSignatures; //u32
+	IdTable bucketLookup; //band key -> index into buckets
+	VarArray buckets; //VarArray of u32 signature indices (unsorted, empty buckets are dropped from bucketLookup and reused)
+	VarArray freeBuckets; //u32
+	VarArray candidateMarks; //u32 (by signature index, equal to candidateStamp if the current query already looked at it)
+	u32 candidateStamp;
+};
+
+#endif //  _APP_TREE_SIMILAR_H
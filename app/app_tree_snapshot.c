@@ -0,0 +1,337 @@
+/*
+File:   app_tree_snapshot.c
+Author: Taylor Robbins
+Date:   10\16\2026
+Description:
+	** Holds the TreeSnapshotPublisher which hands out immutable, reference counted
+	** copies of a SkillTree to worker threads while the main thread keeps editing it
+*/
+
+void FreeTreeSnapshot(TreeSnapshotPublisher* publisher, TreeSnapshot* snapshot)
+{
+	NotNull(publisher);
+	NotNull(snapshot);
+	for (uxx pIndex = 0; pIndex < snapshot->numNodePages; pIndex++)
+	{
+		TreeSnapshotNodePage* page = snapshot->nodePages[pIndex];
+		Assert(page->refCount > 0);
+		page->refCount--;
+		if (page->refCount == 0) { FreeType(TreeSnapshotNodePage, publisher->arena, page); }
+	}
+	for (uxx pIndex = 0; pIndex < snapshot->numBranchPages; pIndex++)
+	{
+		TreeSnapshotBranchPage* page = snapshot->branchPages[pIndex];
+		Assert(page->refCount > 0);
+		page->refCount--;
+		if (page->refCount == 0) { FreeType(TreeSnapshotBranchPage, publisher->arena, page); }
+	}
+	if (snapshot->nodePages != nullptr) { FreeArray(TreeSnapshotNodePage*, publisher->arena, snapshot->numNodePages, snapshot->nodePages); }
+	if (snapshot->branchPages != nullptr) { FreeArray(TreeSnapshotBranchPage*, publisher->arena, snapshot->numBranchPages, snapshot->branchPages); }
+	if (snapshot->namePages != nullptr) { FreeArray(TreeSnapshotNamePage*, publisher->arena, snapshot->numNamePages, snapshot->namePages); }
+	FreeType(TreeSnapshot, publisher->arena, snapshot);
+}
+
+// No reader may be holding (or acquiring) any snapshot when the publisher is freed
+void FreeTreeSnapshotPublisher(TreeSnapshotPublisher* publisher)
+{
+	NotNull(publisher);
+	if (publisher->arena != nullptr)
+	{
+		TreeSnapshot* current = (TreeSnapshot*)TreeAtomicExchangePntr(&publisher->current, nullptr);
+		if (current != nullptr)
+		{
+			Assert(current->refCount == 1);
+			FreeTreeSnapshot(publisher, current);
+		}
+		while (publisher->retired != nullptr)
+		{
+			TreeSnapshot* snapshot = publisher->retired;
+			Assert(snapshot->refCount == 0);
+			publisher->retired = snapshot->nextRetired;
+			FreeTreeSnapshot(publisher, snapshot);
+		}
+		VarArrayLoop(&publisher->namePages, pIndex)
+		{
+			VarArrayLoopGet(TreeSnapshotNamePage*, page, &publisher->namePages, pIndex);
+			FreeType(TreeSnapshotNamePage, publisher->arena, *page);
+		}
+		FreeVarArray(&publisher->namePages);
+		VarArrayLoop(&publisher->nameBlocks, bIndex)
+		{
+			VarArrayLoopGet(Str8, block, &publisher->nameBlocks, bIndex);
+			FreeArray(char, publisher->arena, block->length, block->chars);
+		}
+		FreeVarArray(&publisher->nameBlocks);
+	}
+	ClearPointer(publisher);
+}
+
+void InitTreeSnapshotPublisher(Arena* arena, TreeSnapshotPublisher* publisherOut)
+{
+	NotNull(arena);
+	NotNull(publisherOut);
+	ClearPointer(publisherOut);
+	publisherOut->arena = arena;
+	publisherOut->globalEpoch = 1; //0 in readerEpochs means "not acquiring"
+	InitVarArray(TreeSnapshotNamePage*, &publisherOut->namePages, arena);
+	InitVarArray(Str8, &publisherOut->nameBlocks, arena);
+}
+
+// +==============================+
+// |           Readers            |
+// +==============================+
+// Each thread that wants to acquire snapshots takes a reader slot first (these can be called from any thread)
+uxx RegisterTreeSnapshotReader(TreeSnapshotPublisher* publisher)
+{
+	NotNull(publisher);
+	for (uxx rIndex = 0; rIndex < TREE_SNAPSHOT_MAX_READERS; rIndex++)
+	{
+		if (TreeAtomicCompareExchangeU64(&publisher->readerSlotsTaken[rIndex], 0, 1)) { return rIndex; }
+	}
+	AssertMsg(false, "Ran out of TreeSnapshotPublisher reader slots! Raise TREE_SNAPSHOT_MAX_READERS");
+	return TREE_SNAPSHOT_MAX_READERS;
+}
+void UnregisterTreeSnapshotReader(TreeSnapshotPublisher* publisher, uxx readerIndex)
+{
+	NotNull(publisher);
+	Assert(readerIndex < TREE_SNAPSHOT_MAX_READERS);
+	Assert(TreeAtomicLoadU64(&publisher->readerEpochs[readerIndex]) == 0);
+	TreeAtomicExchangeU64(&publisher->readerSlotsTaken[readerIndex], 0);
+}
+
+// Returns nullptr if nothing has been published yet. The snapshot stays valid (and unchanged) until it's released,
+// no matter how many newer snapshots get published in the meantime. Any thread can call this with its own reader slot
+TreeSnapshot* AcquireTreeSnapshot(TreeSnapshotPublisher* publisher, uxx readerIndex)
+{
+	NotNull(publisher);
+	Assert(readerIndex < TREE_SNAPSHOT_MAX_READERS);
+	// Announcing the epoch before loading current means a snapshot retired after this point can't be freed until we're done here.
+	// The window is only a few instructions long, after that our reference count is what keeps the snapshot alive
+	u64 epoch = TreeAtomicLoadU64(&publisher->globalEpoch);
+	TreeAtomicExchangeU64(&publisher->readerEpochs[readerIndex], epoch);
+	TreeSnapshot* snapshot = (TreeSnapshot*)TreeAtomicLoadPntr(&publisher->current);
+	if (snapshot != nullptr) { TreeAtomicIncrementU64(&snapshot->refCount); }
+	TreeAtomicExchangeU64(&publisher->readerEpochs[readerIndex], 0);
+	return snapshot;
+}
+// Any thread can call this, the memory is given back the next time the publishing thread publishes (or reclaims)
+void ReleaseTreeSnapshot(TreeSnapshot* snapshot)
+{
+	NotNull(snapshot);
+	u64 newRefCount = TreeAtomicDecrementU64(&snapshot->refCount);
+	Assert(newRefCount != UINT64_MAX);
+	UNUSED(newRefCount);
+}
+
+const TreeNode* GetTreeSnapshotNode(const TreeSnapshot* snapshot, uxx nodeIndex)
+{
+	NotNull(snapshot);
+	Assert(nodeIndex < snapshot->numNodeSlots);
+	return &snapshot->nodePages[nodeIndex / TREE_SNAPSHOT_PAGE_SIZE]->nodes[nodeIndex % TREE_SNAPSHOT_PAGE_SIZE];
+}
+uxx GetTreeSnapshotNodeId(const TreeSnapshot* snapshot, uxx nodeIndex)
+{
+	NotNull(snapshot);
+	Assert(nodeIndex < snapshot->numNodeSlots);
+	return snapshot->nodePages[nodeIndex / TREE_SNAPSHOT_PAGE_SIZE]->ids[nodeIndex % TREE_SNAPSHOT_PAGE_SIZE];
+}
+v2 GetTreeSnapshotNodePosition(const TreeSnapshot* snapshot, uxx nodeIndex)
+{
+	NotNull(snapshot);
+	Assert(nodeIndex < snapshot->numNodeSlots);
+	return snapshot->nodePages[nodeIndex / TREE_SNAPSHOT_PAGE_SIZE]->positions[nodeIndex % TREE_SNAPSHOT_PAGE_SIZE];
+}
+Color32 GetTreeSnapshotNodeColor(const TreeSnapshot* snapshot, uxx nodeIndex)
+{
+	NotNull(snapshot);
+	Assert(nodeIndex < snapshot->numNodeSlots);
+	return snapshot->nodePages[nodeIndex / TREE_SNAPSHOT_PAGE_SIZE]->colors[nodeIndex % TREE_SNAPSHOT_PAGE_SIZE];
+}
+const TreeBranch* GetTreeSnapshotBranch(const TreeSnapshot* snapshot, uxx branchIndex)
+{
+	NotNull(snapshot);
+	Assert(branchIndex < snapshot->numBranchSlots);
+	return &snapshot->branchPages[branchIndex / TREE_SNAPSHOT_PAGE_SIZE]->branches[branchIndex % TREE_SNAPSHOT_PAGE_SIZE];
+}
+Str8 GetTreeSnapshotName(const TreeSnapshot* snapshot, u32 nameId)
+{
+	NotNull(snapshot);
+	Assert(nameId < snapshot->numNameIds);
+	return snapshot->namePages[nameId / TREE_SNAPSHOT_PAGE_SIZE]->names[nameId % TREE_SNAPSHOT_PAGE_SIZE];
+}
+
+// +==============================+
+// |          Publishing          |
+// +==============================+
+// True if no reader could still be between loading publisher->current and taking a reference
+// to a snapshot that was retired at retireEpoch (a reader that announced a later epoch loaded a newer snapshot)
+bool IsTreeSnapshotEpochQuiet(TreeSnapshotPublisher* publisher, u64 retireEpoch)
+{
+	for (uxx rIndex = 0; rIndex < TREE_SNAPSHOT_MAX_READERS; rIndex++)
+	{
+		u64 readerEpoch = TreeAtomicLoadU64(&publisher->readerEpochs[rIndex]);
+		if (readerEpoch != 0 && readerEpoch <= retireEpoch) { return false; }
+	}
+	return true;
+}
+
+// Frees the retired snapshots that nobody is holding anymore. Returns how many are still waiting on readers
+uxx ReclaimTreeSnapshots(TreeSnapshotPublisher* publisher)
+{
+	NotNull(publisher);
+	NotNull(publisher->arena);
+	TreeSnapshot** prevNextPntr = &publisher->retired;
+	while (*prevNextPntr != nullptr)
+	{
+		TreeSnapshot* snapshot = *prevNextPntr;
+		if (TreeAtomicLoadU64(&snapshot->refCount) == 0 && IsTreeSnapshotEpochQuiet(publisher, snapshot->retireEpoch))
+		{
+			*prevNextPntr = snapshot->nextRetired;
+			publisher->numRetired--;
+			FreeTreeSnapshot(publisher, snapshot);
+		}
+		else { prevNextPntr = &snapshot->nextRetired; }
+	}
+	return publisher->numRetired;
+}
+
+u64 GetTreeSnapshotPageVersion(VarArray* pageVersions, uxx pageIndex)
+{
+	return (pageIndex < pageVersions->length) ? *VarArrayGetHard(u64, pageVersions, pageIndex) : 0;
+}
+
+// Copies the names that were interned since the last publish. Name pages and blocks are append-only so
+// older snapshots can keep reading the entries below their numNameIds while we add new ones past it
+void UpdateTreeSnapshotNames(TreeSnapshotPublisher* publisher, SkillTree* tree)
+{
+	uxx numNameIds = GetNumStrPoolStrs(&tree->names) + 1; //+1 for STR_POOL_EMPTY_ID
+	for (uxx nameId = publisher->numNameIds; nameId < numNameIds; nameId++)
+	{
+		if (nameId / TREE_SNAPSHOT_PAGE_SIZE >= publisher->namePages.length)
+		{
+			TreeSnapshotNamePage* newPage = AllocType(TreeSnapshotNamePage, publisher->arena);
+			NotNull(newPage);
+			ClearPointer(newPage);
+			*VarArrayAdd(TreeSnapshotNamePage*, &publisher->namePages) = newPage;
+		}
+		Str8 name = GetStrPoolStr(&tree->names, (u32)nameId);
+		Str8 nameCopy = Str8_Empty;
+		if (name.length > 0)
+		{
+			Str8* lastBlock = (publisher->nameBlocks.length > 0) ? VarArrayGetLast(Str8, &publisher->nameBlocks) : nullptr;
+			if (lastBlock == nullptr || publisher->nameBlockUsed + name.length > lastBlock->length)
+			{
+				uxx blockSize = (name.length > TREE_SNAPSHOT_NAME_BLOCK_SIZE) ? name.length : TREE_SNAPSHOT_NAME_BLOCK_SIZE;
+				lastBlock = VarArrayAdd(Str8, &publisher->nameBlocks);
+				lastBlock->chars = AllocArray(char, publisher->arena, blockSize);
+				NotNull(lastBlock->chars);
+				lastBlock->length = blockSize;
+				publisher->nameBlockUsed = 0;
+			}
+			nameCopy = NewStr8(name.length, &lastBlock->chars[publisher->nameBlockUsed]);
+			MyMemCopy(nameCopy.chars, name.chars, name.length);
+			publisher->nameBlockUsed += name.length;
+		}
+		TreeSnapshotNamePage* page = *VarArrayGetHard(TreeSnapshotNamePage*, &publisher->namePages, nameId / TREE_SNAPSHOT_PAGE_SIZE);
+		page->names[nameId % TREE_SNAPSHOT_PAGE_SIZE] = nameCopy;
+	}
+	publisher->numNameIds = numNameIds;
+}
+
+// Makes the tree's current state the snapshot that AcquireTreeSnapshot hands out. Pages that haven't changed since the previous snapshot
+// are shared with it, so the cost is the changed pages plus one pointer per page. Does nothing if the tree hasn't changed
+TreeSnapshot* PublishTreeSnapshot(TreeSnapshotPublisher* publisher, SkillTree* tree)
+{
+	NotNull(publisher);
+	NotNull(publisher->arena);
+	NotNull(tree);
+	Assert(publisher->tree == nullptr || publisher->tree == tree);
+	publisher->tree = tree;
+	TreeSnapshot* previous = publisher->current; //only this thread writes current so we don't need an atomic load
+	if (previous != nullptr && previous->treeVersion == tree->snapshotVersion) { ReclaimTreeSnapshots(publisher); return previous; }
+	
+	UpdateTreeSnapshotNames(publisher, tree);
+	TreeSnapshot* snapshot = AllocType(TreeSnapshot, publisher->arena);
+	NotNull(snapshot);
+	ClearPointer(snapshot);
+	snapshot->refCount = 1;
+	snapshot->treeVersion = tree->snapshotVersion;
+	snapshot->rootHash = GetTreeRootHash(tree);
+	snapshot->numNodes = tree->numNodes;
+	snapshot->numNodeSlots = tree->nodes.length;
+	snapshot->numBranches = tree->numBranches;
+	snapshot->numBranchSlots = tree->branches.length;
+	
+	snapshot->numNodePages = (snapshot->numNodeSlots + TREE_SNAPSHOT_PAGE_SIZE-1) / TREE_SNAPSHOT_PAGE_SIZE;
+	if (snapshot->numNodePages > 0)
+	{
+		snapshot->nodePages = AllocArray(TreeSnapshotNodePage*, publisher->arena, snapshot->numNodePages);
+		NotNull(snapshot->nodePages);
+	}
+	for (uxx pIndex = 0; pIndex < snapshot->numNodePages; pIndex++)
+	{
+		uxx firstSlot = pIndex * TREE_SNAPSHOT_PAGE_SIZE;
+		uxx numSlots = (snapshot->numNodeSlots - firstSlot < TREE_SNAPSHOT_PAGE_SIZE) ? (snapshot->numNodeSlots - firstSlot) : TREE_SNAPSHOT_PAGE_SIZE;
+		bool isUnchanged = (previous != nullptr && firstSlot + numSlots <= previous->numNodeSlots && GetTreeSnapshotPageVersion(&tree->nodePageVersions, pIndex) <= previous->treeVersion);
+		if (isUnchanged)
+		{
+			snapshot->nodePages[pIndex] = previous->nodePages[pIndex];
+			snapshot->nodePages[pIndex]->refCount++;
+			continue;
+		}
+		TreeSnapshotNodePage* page = AllocType(TreeSnapshotNodePage, publisher->arena);
+		NotNull(page);
+		page->refCount = 1;
+		MyMemCopy(&page->ids[0], VarArrayGetHard(uxx, &tree->nodeIds, firstSlot), sizeof(uxx) * numSlots);
+		MyMemCopy(&page->positions[0], VarArrayGetHard(v2, &tree->nodePositions, firstSlot), sizeof(v2) * numSlots);
+		MyMemCopy(&page->colors[0], VarArrayGetHard(Color32, &tree->nodeColors, firstSlot), sizeof(Color32) * numSlots);
+		MyMemCopy(&page->nodes[0], VarArrayGetHard(TreeNode, &tree->nodes, firstSlot), sizeof(TreeNode) * numSlots);
+		snapshot->nodePages[pIndex] = page;
+	}
+	
+	snapshot->numBranchPages = (snapshot->numBranchSlots + TREE_SNAPSHOT_PAGE_SIZE-1) / TREE_SNAPSHOT_PAGE_SIZE;
+	if (snapshot->numBranchPages > 0)
+	{
+		snapshot->branchPages = AllocArray(TreeSnapshotBranchPage*, publisher->arena, snapshot->numBranchPages);
+		NotNull(snapshot->branchPages);
+	}
+	for (uxx pIndex = 0; pIndex < snapshot->numBranchPages; pIndex++)
+	{
+		uxx firstSlot = pIndex * TREE_SNAPSHOT_PAGE_SIZE;
+		uxx numSlots = (snapshot->numBranchSlots - firstSlot < TREE_SNAPSHOT_PAGE_SIZE) ? (snapshot->numBranchSlots - firstSlot) : TREE_SNAPSHOT_PAGE_SIZE;
+		bool isUnchanged = (previous != nullptr && firstSlot + numSlots <= previous->numBranchSlots && GetTreeSnapshotPageVersion(&tree->branchPageVersions, pIndex) <= previous->treeVersion);
+		if (isUnchanged)
+		{
+			snapshot->branchPages[pIndex] = previous->branchPages[pIndex];
+			snapshot->branchPages[pIndex]->refCount++;
+			continue;
+		}
+		TreeSnapshotBranchPage* page = AllocType(TreeSnapshotBranchPage, publisher->arena);
+		NotNull(page);
+		page->refCount = 1;
+		MyMemCopy(&page->branches[0], VarArrayGetHard(TreeBranch, &tree->branches, firstSlot), sizeof(TreeBranch) * numSlots);
+		snapshot->branchPages[pIndex] = page;
+	}
+	
+	snapshot->numNameIds = publisher->numNameIds;
+	snapshot->numNamePages = publisher->namePages.length;
+	if (snapshot->numNamePages > 0)
+	{
+		snapshot->namePages = AllocArray(TreeSnapshotNamePage*, publisher->arena, snapshot->numNamePages);
+		NotNull(snapshot->namePages);
+		MyMemCopy(snapshot->namePages, publisher->namePages.items, sizeof(TreeSnapshotNamePage*) * snapshot->numNamePages);
+	}
+	
+	// Everything above is written before the exchange so a reader that sees the new pointer sees the finished snapshot
+	(void)TreeAtomicExchangePntr(&publisher->current, snapshot);
+	if (previous != nullptr)
+	{
+		previous->retireEpoch = TreeAtomicIncrementU64(&publisher->globalEpoch) - 1;
+		previous->nextRetired = publisher->retired;
+		publisher->retired = previous;
+		publisher->numRetired++;
+		ReleaseTreeSnapshot(previous); //the reference the publisher was holding
+	}
+	ReclaimTreeSnapshots(publisher);
+	return snapshot;
+}
@@ -0,0 +1,104 @@
+/*
+File:   app_tree_snapshot.h
+Author: Taylor Robbins
+Date:   10\16\2026
+*/
+
+#ifndef _APP_TREE_SNAPSHOT_H
+#define _APP_TREE_SNAPSHOT_H
+
+#define TREE_SNAPSHOT_MAX_READERS      16 //threads that can hold a reader slot at the same time
+#define TREE_SNAPSHOT_NAME_BLOCK_SIZE  Kilobytes(16) //names are copied into blocks of (at least) this size
+
+// The handful of atomic operations the snapshot readers and publisher need. All of them are sequentially consistent
+#if COMPILER_IS_MSVC
+#define TreeAtomicLoadU64(pntr)                             (u64)_InterlockedOr64((volatile long long*)(pntr), 0)
+#define TreeAtomicExchangeU64(pntr, value)                  (u64)_InterlockedExchange64((volatile long long*)(pntr), (long long)(value))
+#define TreeAtomicCompareExchangeU64(pntr, expected, value) ((u64)_InterlockedCompareExchange64((volatile long long*)(pntr), (long long)(value), (long long)(expected)) == (u64)(expected))
+#define TreeAtomicIncrementU64(pntr)                        (u64)_InterlockedIncrement64((volatile long long*)(pntr))
+#define TreeAtomicDecrementU64(pntr)                        (u64)_InterlockedDecrement64((volatile long long*)(pntr))
+#define TreeAtomicLoadPntr(pntr)                            _InterlockedCompareExchangePointer((void* volatile*)(pntr), nullptr, nullptr)
+#define TreeAtomicExchangePntr(pntr, value)                 _InterlockedExchangePointer((void* volatile*)(pntr), (void*)(value))
+#else
+#define TreeAtomicLoadU64(pntr)                             __atomic_load_n((pntr), __ATOMIC_SEQ_CST)
+#define TreeAtomicExchangeU64(pntr, value)                  __atomic_exchange_n((pntr), (u64)(value), __ATOMIC_SEQ_CST)
+#define TreeAtomicCompareExchangeU64(pntr, expected, value) __extension__({ u64 _expected = (u64)(expected); __atomic_compare_exchange_n((pntr), &_expected, (u64)(value), false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST); })
+#define TreeAtomicIncrementU64(pntr)                        __atomic_add_fetch((pntr), 1, __ATOMIC_SEQ_CST)
+#define TreeAtomicDecrementU64(pntr)                        __atomic_sub_fetch((pntr), 1, __ATOMIC_SEQ_CST)
+#define TreeAtomicLoadPntr(pntr)                            __atomic_load_n((void**)(pntr), __ATOMIC_SEQ_CST)
+#define TreeAtomicExchangePntr(pntr, value)                 __atomic_exchange_n((void**)(pntr), (void*)(value), __ATOMIC_SEQ_CST)
+#endif
+
+// Pages are shared between every snapshot that saw the same contents. refCount counts those
+// snapshots and is only touched on the publishing thread so it doesn't need to be atomic
+typedef struct TreeSnapshotNodePage TreeSnapshotNodePage;
+struct TreeSnapshotNodePage
+{
+	uxx refCount;
+	uxx ids[TREE_SNAPSHOT_PAGE_SIZE];
+	v2 positions[TREE_SNAPSHOT_PAGE_SIZE];
+	Color32 colors[TREE_SNAPSHOT_PAGE_SIZE];
+	TreeNode nodes[TREE_SNAPSHOT_PAGE_SIZE];
+};
+typedef struct TreeSnapshotBranchPage TreeSnapshotBranchPage;
+struct TreeSnapshotBranchPage
+{
+	uxx refCount;
+	TreeBranch branches[TREE_SNAPSHOT_PAGE_SIZE];
+};
+// Names are only ever appended (like the StrPool they come from) so name pages are owned by the publisher, not shared
+typedef struct TreeSnapshotNamePage TreeSnapshotNamePage;
+struct TreeSnapshotNamePage
+{
+	Str8 names[TREE_SNAPSHOT_PAGE_SIZE];
+};
+
+// An immutable copy of the nodes, branches and names of a SkillTree at one point in time, laid out by the same
+// node/branch indices (so handles in the branches resolve the same way they do in the tree). Nothing in a snapshot
+// is ever written after it's published, so any number of threads can read one without locking
+typedef struct TreeSnapshot TreeSnapshot;
+struct TreeSnapshot
+{
+	u64 refCount; //atomic, the publisher holds one reference while this is the current snapshot
+	u64 retireEpoch; //TreeSnapshotPublisher::globalEpoch when this stopped being the current snapshot
+	TreeSnapshot* nextRetired;
+	u64 treeVersion; //SkillTree::snapshotVersion when this was published
+	u64 rootHash; //GetTreeRootHash when this was published, compare against the tree's to see if anything changed since
+	uxx numNodes;
+	uxx numNodeSlots;
+	uxx numNodePages;
+	TreeSnapshotNodePage** nodePages;
+	uxx numBranches;
+	uxx numBranchSlots;
+	uxx numBranchPages;
+	TreeSnapshotBranchPage** branchPages;
+	uxx numNameIds; //name ids [0, numNameIds) are valid
+	uxx numNamePages;
+	TreeSnapshotNamePage** namePages;
+};
+
+// Publishes TreeSnapshots of one SkillTree for worker threads, RCU style. The thread that edits the tree calls
+// PublishTreeSnapshot after its edits, which copies only the pages that changed (see SkillTree::snapshotVersion) and shares the rest
+// with the previous snapshot. Readers grab the current snapshot with AcquireTreeSnapshot and give it back with ReleaseTreeSnapshot.
+// Replaced snapshots are retired and the publishing thread frees them once no reader holds them and no reader can still be
+// in the middle of acquiring them (readers announce the epoch they started acquiring in, see IsTreeSnapshotEpochQuiet).
+// Everything except Acquire/Release/Register/Unregister must be called on the publishing thread
+typedef struct TreeSnapshotPublisher TreeSnapshotPublisher;
+struct TreeSnapshotPublisher
+{
+	Arena* arena;
+	SkillTree* tree; //the tree we've been publishing, a publisher only ever follows one tree
+	TreeSnapshot* current; //atomic
+	TreeSnapshot* retired; //linked list through nextRetired
+	uxx numRetired;
+	u64 globalEpoch; //atomic, incremented every time a snapshot is retired
+	u64 readerEpochs[TREE_SNAPSHOT_MAX_READERS]; //atomic, the epoch a reader read before loading current (0 when it's not acquiring)
+	u64 readerSlotsTaken[TREE_SNAPSHOT_MAX_READERS]; //atomic
+	
+	uxx numNameIds; //how many StrPool ids have been copied into namePages
+	VarArray namePages; //TreeSnapshotNamePage*
+	VarArray nameBlocks; //Str8 (length is the capacity of the block)
+	uxx nameBlockUsed; //chars used in the last block
+};
+
+#endif //  _APP_TREE_SNAPSHOT_H
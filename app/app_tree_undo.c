@@ -0,0 +1,291 @@
+/*
+File:   app_tree_undo.c
+Author: Taylor Robbins
+Date:   10\16\2026
+Description:
+	** Holds the TreeUndoJournal, a fixed size undo/redo history of small deltas
+	** (node moves, node/branch adds and removes, renames) made against a SkillTree
+*/
+
+void FreeTreeUndoJournal(TreeUndoJournal* journal)
+{
+	NotNull(journal);
+	if (journal->arena != nullptr && journal->records != nullptr)
+	{
+		FreeArray(TreeUndoRecord, journal->arena, journal->capacity, journal->records);
+	}
+	ClearPointer(journal);
+}
+
+void InitTreeUndoJournal(Arena* arena, uxx budgetBytes, TreeUndoJournal* journalOut)
+{
+	NotNull(arena);
+	NotNull(journalOut);
+	ClearPointer(journalOut);
+	journalOut->arena = arena;
+	journalOut->capacity = budgetBytes / sizeof(TreeUndoRecord);
+	Assert(journalOut->capacity > 0);
+	journalOut->records = AllocArray(TreeUndoRecord, arena, journalOut->capacity);
+	NotNull(journalOut->records);
+	journalOut->nextGroup = 1;
+}
+
+void ClearTreeUndoJournal(TreeUndoJournal* journal)
+{
+	NotNull(journal);
+	journal->firstIndex = 0;
+	journal->numRecords = 0;
+	journal->numApplied = 0;
+}
+
+TreeUndoRecord* GetTreeUndoRecord(TreeUndoJournal* journal, uxx index)
+{
+	Assert(index < journal->numRecords);
+	return &journal->records[(journal->firstIndex + index) % journal->capacity];
+}
+
+bool CanUndoTreeEdit(const TreeUndoJournal* journal) { return (journal->numApplied > 0); }
+bool CanRedoTreeEdit(const TreeUndoJournal* journal) { return (journal->numApplied < journal->numRecords); }
+
+// Everything recorded between Begin and End is undone as one step (these can be nested, only the outermost pair matters)
+void BeginTreeUndoGroup(TreeUndoJournal* journal)
+{
+	NotNull(journal);
+	if (journal->groupDepth == 0)
+	{
+		journal->openGroup = journal->nextGroup;
+		journal->nextGroup++;
+		journal->openGroupOverflowed = false;
+	}
+	journal->groupDepth++;
+}
+void EndTreeUndoGroup(TreeUndoJournal* journal)
+{
+	NotNull(journal);
+	Assert(journal->groupDepth > 0);
+	journal->groupDepth--;
+	// Half of a group can't be undone correctly, so if the group didn't fit in the ring we have to forget the history instead
+	if (journal->groupDepth == 0 && journal->openGroupOverflowed) { ClearTreeUndoJournal(journal); }
+}
+
+TreeUndoRecord* PushTreeUndoRecord(TreeUndoJournal* journal, TreeUndoRecordType type)
+{
+	NotNull(journal);
+	NotNull(journal->records);
+	journal->numRecords = journal->numApplied; //anything that could be redone is lost once something new happens
+	
+	if (journal->numRecords == journal->capacity)
+	{
+		u32 evictGroup = GetTreeUndoRecord(journal, 0)->group;
+		if (journal->groupDepth > 0 && evictGroup == journal->openGroup) { journal->openGroupOverflowed = true; }
+		while (journal->numRecords > 0 && GetTreeUndoRecord(journal, 0)->group == evictGroup)
+		{
+			journal->firstIndex = (journal->firstIndex + 1) % journal->capacity;
+			journal->numRecords--;
+			journal->numApplied--;
+			if (evictGroup == journal->openGroup && journal->groupDepth > 0) { break; } //only make room for one record at a time from the group we are filling
+		}
+	}
+	
+	journal->numRecords++;
+	journal->numApplied++;
+	TreeUndoRecord* result = GetTreeUndoRecord(journal, journal->numRecords-1);
+	ClearPointer(result);
+	result->type = (u8)type;
+	if (journal->groupDepth > 0) { result->group = journal->openGroup; }
+	else { result->group = journal->nextGroup; journal->nextGroup++; }
+	return result;
+}
+
+// +--------------------------------------------------------------+
+// |                          Recording                           |
+// +--------------------------------------------------------------+
+// A drag should be recorded once when it ends (with the position from when it started), not every frame
+void RecordTreeNodeMove(TreeUndoJournal* journal, uxx nodeId, v2 oldPosition, v2 newPosition)
+{
+	if (AreEqualV2(oldPosition, newPosition)) { return; }
+	TreeUndoRecord* record = PushTreeUndoRecord(journal, TreeUndoRecordType_MoveNode);
+	record->move.nodeId = nodeId;
+	record->move.oldPosition = oldPosition;
+	record->move.newPosition = newPosition;
+}
+
+void FillTreeUndoNodeRecord(SkillTree* tree, TreeUndoRecord* record, const TreeNode* node)
+{
+	record->node.nodeId = node->id;
+	record->node.nodeType = (u8)node->type;
+	record->node.nameId = node->nameId;
+	record->node.position = GetTreeNodePosition(tree, node);
+	record->node.color = GetTreeNodeColor(tree, node);
+}
+void FillTreeUndoBranchRecord(TreeUndoRecord* record, const TreeBranch* branch)
+{
+	record->branch.branchType = (u8)branch->type;
+	record->branch.nameId = branch->nameId;
+	record->branch.fromId = branch->fromId;
+	record->branch.toId = branch->toId;
+}
+
+// Call after the node was added
+void RecordTreeNodeAdd(TreeUndoJournal* journal, SkillTree* tree, const TreeNode* node)
+{
+	NotNull(tree);
+	NotNull(node);
+	FillTreeUndoNodeRecord(tree, PushTreeUndoRecord(journal, TreeUndoRecordType_AddNode), node);
+}
+
+// Call before the node is removed. This also records every branch attached to the node, since removing a node
+// through RemoveTreeNodesAndBranches removes those too and undo should bring them back
+void RecordTreeNodeRemoval(TreeUndoJournal* journal, SkillTree* tree, const TreeNode* node)
+{
+	NotNull(tree);
+	NotNull(node);
+	BeginTreeUndoGroup(journal);
+	if (tree->referencesBaked)
+	{
+		TreeRefIter iter = NewTreeRefIter(tree, (TreeNode*)node, true, true, TreeBranchTypeFlags_All);
+		while (TreeRefIterStep(&iter))
+		{
+			if (iter.isIncoming && iter.branch->fromId == node->id) { continue; } //self-loops show up in both directions
+			FillTreeUndoBranchRecord(PushTreeUndoRecord(journal, TreeUndoRecordType_RemoveBranch), iter.branch);
+		}
+	}
+	else
+	{
+		VarArrayLoop(&tree->branches, bIndex)
+		{
+			VarArrayLoopGet(TreeBranch, branch, &tree->branches, bIndex);
+			if (!IsTreeSlotGenerationAlive(branch->generation)) { continue; }
+			if (branch->fromId != node->id && branch->toId != node->id) { continue; }
+			FillTreeUndoBranchRecord(PushTreeUndoRecord(journal, TreeUndoRecordType_RemoveBranch), branch);
+		}
+	}
+	FillTreeUndoNodeRecord(tree, PushTreeUndoRecord(journal, TreeUndoRecordType_RemoveNode), node);
+	EndTreeUndoGroup(journal);
+}
+
+// Call after the branch was added
+void RecordTreeBranchAdd(TreeUndoJournal* journal, const TreeBranch* branch)
+{
+	NotNull(branch);
+	FillTreeUndoBranchRecord(PushTreeUndoRecord(journal, TreeUndoRecordType_AddBranch), branch);
+}
+// Call before the branch is removed
+void RecordTreeBranchRemoval(TreeUndoJournal* journal, const TreeBranch* branch)
+{
+	NotNull(branch);
+	FillTreeUndoBranchRecord(PushTreeUndoRecord(journal, TreeUndoRecordType_RemoveBranch), branch);
+}
+
+void RecordTreeNodeRename(TreeUndoJournal* journal, uxx nodeId, u32 oldNameId, u32 newNameId)
+{
+	if (oldNameId == newNameId) { return; }
+	TreeUndoRecord* record = PushTreeUndoRecord(journal, TreeUndoRecordType_RenameNode);
+	record->rename.nodeId = nodeId;
+	record->rename.oldNameId = oldNameId;
+	record->rename.newNameId = newNameId;
+}
+
+// +--------------------------------------------------------------+
+// |                        Undo and Redo                         |
+// +--------------------------------------------------------------+
+// If the tree was edited without being recorded the record might not apply cleanly anymore (e.g. the node is already gone).
+// Those records are skipped rather than asserting, the rest of the group still gets applied.
+// Returns false if the tree refused the change (a Dependency that would close a cycle in the tree as it is now)
+bool ApplyTreeUndoRecord(SkillTree* tree, const TreeUndoRecord* record, bool forward)
+{
+	NotNull(tree);
+	NotNull(record);
+	TreeUndoRecordType type = (TreeUndoRecordType)record->type;
+	switch (type)
+	{
+		case TreeUndoRecordType_MoveNode:
+		{
+			TreeNode* node = GetTreeNodeById(tree, record->move.nodeId);
+			if (node != nullptr) { SetTreeNodePosition(tree, node, forward ? record->move.newPosition : record->move.oldPosition); }
+		} break;
+		
+		case TreeUndoRecordType_AddNode:
+		case TreeUndoRecordType_RemoveNode:
+		{
+			bool shouldExist = (forward == (type == TreeUndoRecordType_AddNode));
+			TreeNode* node = GetTreeNodeById(tree, record->node.nodeId);
+			if (shouldExist && node == nullptr)
+			{
+				AddTreeNodeWithId(tree, record->node.nodeId, (TreeNodeType)record->node.nodeType, record->node.nameId, record->node.position, record->node.color);
+			}
+			else if (!shouldExist && node != nullptr)
+			{
+				RemoveTreeNode(tree, node);
+			}
+		} break;
+		
+		case TreeUndoRecordType_AddBranch:
+		case TreeUndoRecordType_RemoveBranch:
+		{
+			bool shouldExist = (forward == (type == TreeUndoRecordType_AddBranch));
+			TreeBranchType branchType = (TreeBranchType)record->branch.branchType;
+			if (shouldExist)
+			{
+				TreeBranch* branch = AddTreeBranchWithNameId(tree, branchType, record->branch.nameId, record->branch.fromId, record->branch.toId);
+				if (branch == nullptr) { return false; }
+			}
+			else
+			{
+				TreeBranch* branch = FindTreeBranch(tree, branchType, record->branch.fromId, record->branch.toId);
+				if (branch != nullptr) { RemoveTreeBranch(tree, branch); }
+			}
+		} break;
+		
+		case TreeUndoRecordType_RenameNode:
+		{
+			TreeNode* node = GetTreeNodeById(tree, record->rename.nodeId);
+			if (node != nullptr) { SetTreeNodeNameId(tree, node, forward ? record->rename.newNameId : record->rename.oldNameId); }
+		} break;
+		
+		default: Assert(false); break;
+	}
+	return true;
+}
+
+// Returns false if there was nothing to undo, or the tree refused one of the records. The records that were undone before that
+// stay undone (and can be redone) but everything older than the refused record is dropped, since it was recorded on top of it
+bool UndoTreeEdit(TreeUndoJournal* journal, SkillTree* tree)
+{
+	NotNull(journal);
+	Assert(journal->groupDepth == 0);
+	if (journal->numApplied == 0) { return false; }
+	u32 group = GetTreeUndoRecord(journal, journal->numApplied-1)->group;
+	while (journal->numApplied > 0 && GetTreeUndoRecord(journal, journal->numApplied-1)->group == group)
+	{
+		if (!ApplyTreeUndoRecord(tree, GetTreeUndoRecord(journal, journal->numApplied-1), false))
+		{
+			journal->firstIndex = (journal->firstIndex + journal->numApplied) % journal->capacity;
+			journal->numRecords -= journal->numApplied;
+			journal->numApplied = 0;
+			return false;
+		}
+		journal->numApplied--;
+	}
+	return true;
+}
+
+// Returns false if there was nothing to redo, or the tree refused one of the records. The records that were redone before that
+// stay applied (and can be undone) but the refused record and everything after it is dropped from the redo history
+bool RedoTreeEdit(TreeUndoJournal* journal, SkillTree* tree)
+{
+	NotNull(journal);
+	Assert(journal->groupDepth == 0);
+	if (journal->numApplied >= journal->numRecords) { return false; }
+	u32 group = GetTreeUndoRecord(journal, journal->numApplied)->group;
+	while (journal->numApplied < journal->numRecords && GetTreeUndoRecord(journal, journal->numApplied)->group == group)
+	{
+		if (!ApplyTreeUndoRecord(tree, GetTreeUndoRecord(journal, journal->numApplied), true))
+		{
+			journal->numRecords = journal->numApplied;
+			return false;
+		}
+		journal->numApplied++;
+	}
+	return true;
+}
@@ -0,0 +1,73 @@
+/*
+File:   app_tree_undo.h
+Author: Taylor Robbins
+Date:   10\16\2026
+*/
+
+#ifndef _APP_TREE_UNDO_H
+#define _APP_TREE_UNDO_H
+
+typedef enum TreeUndoRecordType TreeUndoRecordType;
+enum TreeUndoRecordType
+{
+	TreeUndoRecordType_None = 0,
+	TreeUndoRecordType_MoveNode,
+	TreeUndoRecordType_AddNode,
+	TreeUndoRecordType_RemoveNode,
+	TreeUndoRecordType_AddBranch,
+	TreeUndoRecordType_RemoveBranch,
+	TreeUndoRecordType_RenameNode,
+	TreeUndoRecordType_Count,
+};
+const char* GetTreeUndoRecordTypeStr(TreeUndoRecordType enumValue)
+{
+	switch (enumValue)
+	{
+		case TreeUndoRecordType_None:         return "None";
+		case TreeUndoRecordType_MoveNode:     return "MoveNode";
+		case TreeUndoRecordType_AddNode:      return "AddNode";
+		case TreeUndoRecordType_RemoveNode:   return "RemoveNode";
+		case TreeUndoRecordType_AddBranch:    return "AddBranch";
+		case TreeUndoRecordType_RemoveBranch: return "RemoveBranch";
+		case TreeUndoRecordType_RenameNode:   return "RenameNode";
+		default: return UNKNOWN_STR;
+	}
+}
+
+// Every record is the same (small) size so the journal can be a plain ring of records.
+// Names are stored as ids into tree->names rather than copies of the string, that works
+// because interned strings are never removed from the pool so the ids stay valid forever
+typedef struct TreeUndoRecord TreeUndoRecord;
+struct TreeUndoRecord
+{
+	u8 type; //TreeUndoRecordType
+	u32 group; //consecutive records with the same group are undone/redone together
+	union
+	{
+		struct { uxx nodeId; v2 oldPosition; v2 newPosition; } move; //MoveNode
+		struct { uxx nodeId; v2 position; Color32 color; u32 nameId; u8 nodeType; } node; //AddNode, RemoveNode
+		struct { uxx fromId; uxx toId; u32 nameId; u8 branchType; } branch; //AddBranch, RemoveBranch
+		struct { uxx nodeId; u32 oldNameId; u32 newNameId; } rename; //RenameNode
+	};
+};
+
+// Records are kept in a ring sized from a byte budget when the journal is created. Once it's full, recording
+// something new evicts the oldest group, so undo history never takes more memory than the budget no matter how big the tree is.
+// The records in [0, numApplied) can be undone and [numApplied, numRecords) can be redone (recording something new drops those).
+// The journal doesn't hook into the tree, whoever edits the tree calls the matching Record function
+typedef struct TreeUndoJournal TreeUndoJournal;
+struct TreeUndoJournal
+{
+	Arena* arena;
+	uxx capacity; //in records
+	TreeUndoRecord* records;
+	uxx firstIndex; //ring index of the oldest record
+	uxx numRecords;
+	uxx numApplied;
+	u32 nextGroup;
+	uxx groupDepth; //BeginTreeUndoGroup nesting
+	u32 openGroup;
+	bool openGroupOverflowed; //the open group got bigger than the whole ring so part of it was evicted
+};
+
+#endif //  _APP_TREE_UNDO_H
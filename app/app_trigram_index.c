@@ -0,0 +1,251 @@
+/*
+File:   app_trigram_index.c
+Author: Taylor Robbins
+Date:   10\16\2026
+Description:
+	** Holds the TrigramIndex, an inverted index from trigrams to items that
+	** is used for fuzzy searching short strings (like node names) as the user types
+*/
+
+#define GetTrigramKey(chars) (((uxx)(u8)(chars)[0] << 16) | ((uxx)(u8)(chars)[1] << 8) | (uxx)(u8)(chars)[2])
+
+void FreeTrigramIndex(TrigramIndex* index)
+{
+	NotNull(index);
+	if (index->arena != nullptr)
+	{
+		VarArrayLoop(&index->postings, pIndex)
+		{
+			VarArrayLoopGet(VarArray, posting, &index->postings, pIndex);
+			FreeVarArray(posting);
+		}
+		FreeVarArray(&index->postings);
+		FreeIdTable(&index->lookup);
+		FreeVarArray(&index->itemNumTrigrams);
+		FreeVarArray(&index->itemSharedCounts);
+	}
+	ClearPointer(index);
+}
+
+void InitTrigramIndex(Arena* arena, TrigramIndex* indexOut)
+{
+	NotNull(arena);
+	NotNull(indexOut);
+	ClearPointer(indexOut);
+	indexOut->arena = arena;
+	InitIdTable(arena, &indexOut->lookup);
+	InitVarArray(VarArray, &indexOut->postings, arena);
+	InitVarArray(u32, &indexOut->itemNumTrigrams, arena);
+	InitVarArray(u32, &indexOut->itemSharedCounts, arena);
+}
+
+u8 NormalizeTrigramChar(u8 character)
+{
+	if (character >= 'A' && character <= 'Z') { return (u8)(character - 'A' + 'a'); }
+	if (character <= ' ' || character == 0x7F) { return TRIGRAM_PAD_CHAR; }
+	return character; //NOTE: UTF-8 bytes are left alone, they just match byte-for-byte
+}
+
+// Returns an empty string if the text is empty (or all whitespace). Otherwise the result is at least 3 chars long.
+// Queries don't get the padding at the end since the user is probably still typing the rest of the word
+Str8 NormalizeTrigramText(Arena* arena, Str8 text, bool padEnd)
+{
+	u8* chars = AllocArray(u8, arena, text.length + 3);
+	NotNull(chars);
+	uxx length = 0;
+	chars[length++] = TRIGRAM_PAD_CHAR;
+	chars[length++] = TRIGRAM_PAD_CHAR;
+	for (uxx cIndex = 0; cIndex < text.length; cIndex++)
+	{
+		u8 character = NormalizeTrigramChar((u8)text.chars[cIndex]);
+		if (character == TRIGRAM_PAD_CHAR && chars[length-1] == TRIGRAM_PAD_CHAR) { continue; }
+		chars[length++] = character;
+	}
+	if (length == 2) { return Str8_Empty; }
+	if (chars[length-1] == TRIGRAM_PAD_CHAR) { if (!padEnd) { length--; } }
+	else if (padEnd) { chars[length++] = TRIGRAM_PAD_CHAR; }
+	return NewStr8(length, chars);
+}
+
+// Makes room for items [0, numItems) so adding them doesn't grow the per-item arrays one at a time
+void ReserveTrigramIndexItems(TrigramIndex* index, uxx numItems)
+{
+	NotNull(index);
+	NotNull(index->arena);
+	VarArrayExpand(&index->itemNumTrigrams, numItems);
+	VarArrayExpand(&index->itemSharedCounts, numItems);
+}
+
+// An item that is already in the index has to be removed (with its old text) before it can be added again
+void AddTrigramIndexItem(TrigramIndex* index, uxx itemIndex, Str8 text)
+{
+	NotNull(index);
+	NotNull(index->arena);
+	Assert(itemIndex < UINT32_MAX);
+	while (index->itemNumTrigrams.length <= itemIndex)
+	{
+		*VarArrayAdd(u32, &index->itemNumTrigrams) = 0;
+		*VarArrayAdd(u32, &index->itemSharedCounts) = 0;
+	}
+	u32* numTrigrams = VarArrayGetHard(u32, &index->itemNumTrigrams, itemIndex);
+	Assert(*numTrigrams == 0);
+	ScratchBegin1(scratch, index->arena);
+	
+	Str8 normalized = NormalizeTrigramText(scratch, text, true);
+	for (uxx cIndex = 0; cIndex + 3 <= normalized.length; cIndex++)
+	{
+		uxx key = GetTrigramKey(&normalized.chars[cIndex]);
+		uxx postingIndex = 0;
+		if (!IdTableFind(&index->lookup, key, &postingIndex))
+		{
+			postingIndex = index->postings.length;
+			InitVarArray(u32, VarArrayAdd(VarArray, &index->postings), index->arena);
+			IdTableSet(&index->lookup, key, postingIndex);
+		}
+		VarArray* posting = VarArrayGetHard(VarArray, &index->postings, postingIndex);
+		// A trigram can show up more than once in the same text, if we already added this item it's the last one in the posting list
+		if (posting->length > 0 && *VarArrayGetLast(u32, posting) == (u32)itemIndex) { continue; }
+		*VarArrayAdd(u32, posting) = (u32)itemIndex;
+		(*numTrigrams)++;
+	}
+	if (*numTrigrams > 0) { index->numItems++; }
+	
+	ScratchEnd(scratch);
+}
+
+// The text must be the same text that the item was added with
+void RemoveTrigramIndexItem(TrigramIndex* index, uxx itemIndex, Str8 text)
+{
+	NotNull(index);
+	if (itemIndex >= index->itemNumTrigrams.length) { return; }
+	u32* numTrigrams = VarArrayGetHard(u32, &index->itemNumTrigrams, itemIndex);
+	if (*numTrigrams == 0) { return; }
+	ScratchBegin1(scratch, index->arena);
+	
+	Str8 normalized = NormalizeTrigramText(scratch, text, true);
+	for (uxx cIndex = 0; cIndex + 3 <= normalized.length; cIndex++)
+	{
+		uxx postingIndex = 0;
+		if (!IdTableFind(&index->lookup, GetTrigramKey(&normalized.chars[cIndex]), &postingIndex)) { Assert(false); continue; }
+		VarArray* posting = VarArrayGetHard(VarArray, &index->postings, postingIndex);
+		u32* items = (u32*)posting->items;
+		// Order doesn't matter in a posting list so we swap the last item into the hole. Repeated trigrams won't be found the second time around
+		for (uxx pIndex = posting->length; pIndex > 0; pIndex--)
+		{
+			if (items[pIndex-1] != (u32)itemIndex) { continue; }
+			items[pIndex-1] = items[posting->length-1];
+			VarArrayRemoveAt(u32, posting, posting->length-1);
+			Assert(*numTrigrams > 0);
+			(*numTrigrams)--;
+			break;
+		}
+	}
+	Assert(*numTrigrams == 0);
+	*numTrigrams = 0;
+	index->numItems--;
+	
+	ScratchEnd(scratch);
+}
+
+bool IsTrigramMatchBetter(const TrigramMatch* left, const TrigramMatch* right)
+{
+	if (left->score != right->score) { return (left->score > right->score); }
+	return (left->itemIndex < right->itemIndex);
+}
+
+// Fills matchesOut with the best (up to) maxMatches items, best first, and returns how many were found.
+// Only the posting lists for the query's trigrams are walked, and the per-item counters are reset
+// as we go through the items we touched, so the cost is proportional to the size of those posting lists
+uxx SearchTrigramIndex(TrigramIndex* index, Str8 query, uxx maxMatches, TrigramMatch* matchesOut)
+{
+	NotNull(index);
+	Assert(matchesOut != nullptr || maxMatches == 0);
+	if (maxMatches == 0 || index->numItems == 0) { return 0; }
+	ScratchBegin1(scratch, index->arena);
+	
+	Str8 normalized = NormalizeTrigramText(scratch, query, false);
+	uxx numQueryTrigrams = 0;
+	uxx* queryKeys = AllocArray(uxx, scratch, normalized.length + 1);
+	NotNull(queryKeys);
+	for (uxx cIndex = 0; cIndex + 3 <= normalized.length; cIndex++)
+	{
+		uxx key = GetTrigramKey(&normalized.chars[cIndex]);
+		bool isRepeat = false;
+		for (uxx qIndex = 0; qIndex < numQueryTrigrams; qIndex++) { if (queryKeys[qIndex] == key) { isRepeat = true; break; } }
+		if (!isRepeat) { queryKeys[numQueryTrigrams++] = key; }
+	}
+	
+	// Shortest posting lists first. An item that isn't in any of the first (numQueryTrigrams - minShared + 1) lists
+	// can't reach minShared, so the rest of the lists (the longest ones) only need to bump items we've already seen
+	uxx minShared = (numQueryTrigrams + TRIGRAM_MIN_SHARED_DIVISOR - 1) / TRIGRAM_MIN_SHARED_DIVISOR;
+	VarArray** queryPostings = AllocArray(VarArray*, scratch, numQueryTrigrams + 1);
+	NotNull(queryPostings);
+	uxx numQueryPostings = 0;
+	uxx maxTouched = 0;
+	for (uxx qIndex = 0; qIndex < numQueryTrigrams; qIndex++)
+	{
+		uxx postingIndex = 0;
+		if (!IdTableFind(&index->lookup, queryKeys[qIndex], &postingIndex)) { continue; }
+		VarArray* posting = VarArrayGetHard(VarArray, &index->postings, postingIndex);
+		uxx insertIndex = numQueryPostings;
+		while (insertIndex > 0 && queryPostings[insertIndex-1]->length > posting->length) { queryPostings[insertIndex] = queryPostings[insertIndex-1]; insertIndex--; }
+		queryPostings[insertIndex] = posting;
+		numQueryPostings++;
+		maxTouched += posting->length;
+	}
+	// Trigrams that nobody has count as empty lists at the front
+	uxx numCandidateLists = (numQueryPostings >= minShared) ? (numQueryPostings - minShared + 1) : 0;
+	
+	uxx numTouched = 0;
+	u32* touchedItems = AllocArray(u32, scratch, maxTouched + 1);
+	NotNull(touchedItems);
+	u32* sharedCounts = (u32*)index->itemSharedCounts.items;
+	for (uxx pIndex = 0; pIndex < numQueryPostings; pIndex++)
+	{
+		const u32* items = (const u32*)queryPostings[pIndex]->items;
+		uxx numItems = queryPostings[pIndex]->length;
+		if (pIndex < numCandidateLists)
+		{
+			for (uxx iIndex = 0; iIndex < numItems; iIndex++)
+			{
+				u32 itemIndex = items[iIndex];
+				if (sharedCounts[itemIndex] == 0) { touchedItems[numTouched++] = itemIndex; }
+				sharedCounts[itemIndex]++;
+			}
+		}
+		else
+		{
+			for (uxx iIndex = 0; iIndex < numItems; iIndex++)
+			{
+				u32 itemIndex = items[iIndex];
+				if (sharedCounts[itemIndex] != 0) { sharedCounts[itemIndex]++; }
+			}
+		}
+	}
+	
+	const u32* itemNumTrigrams = (const u32*)index->itemNumTrigrams.items;
+	uxx numMatches = 0;
+	for (uxx tIndex = 0; tIndex < numTouched; tIndex++)
+	{
+		TrigramMatch match = ZEROED;
+		match.itemIndex = touchedItems[tIndex];
+		match.numShared = sharedCounts[match.itemIndex];
+		sharedCounts[match.itemIndex] = 0;
+		if (match.numShared < minShared) { continue; }
+		match.score = (2.0f * (r32)match.numShared) / (r32)(numQueryTrigrams + itemNumTrigrams[match.itemIndex]);
+		if (numMatches == maxMatches && !IsTrigramMatchBetter(&match, &matchesOut[numMatches-1])) { continue; }
+		
+		// Insertion sort into the results, maxMatches is small so this is cheaper than sorting all the touched items
+		uxx insertIndex = (numMatches < maxMatches) ? numMatches : maxMatches-1;
+		while (insertIndex > 0 && IsTrigramMatchBetter(&match, &matchesOut[insertIndex-1]))
+		{
+			matchesOut[insertIndex] = matchesOut[insertIndex-1];
+			insertIndex--;
+		}
+		matchesOut[insertIndex] = match;
+		if (numMatches < maxMatches) { numMatches++; }
+	}
+	
+	ScratchEnd(scratch);
+	return numMatches;
+}
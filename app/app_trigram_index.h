@@ -0,0 +1,39 @@
+/*
+File:   app_trigram_index.h
+Author: Taylor Robbins
+Date:   10\16\2026
+*/
+
+#ifndef _APP_TRIGRAM_INDEX_H
+#define _APP_TRIGRAM_INDEX_H
+
+// Text is lowercased, runs of whitespace become a single space, and it's padded with two spaces in front and one behind
+// so that "Rust" gives "  r", " ru", "rus", "ust", "st ". The padding is what makes prefixes rank above matches in the middle of a word
+#define TRIGRAM_PAD_CHAR  ' '
+// A match has to share at least 1/TRIGRAM_MIN_SHARED_DIVISOR of the query's trigrams (rounded up) to be returned
+#define TRIGRAM_MIN_SHARED_DIVISOR  3
+
+typedef struct TrigramMatch TrigramMatch;
+struct TrigramMatch
+{
+	u32 itemIndex;
+	u32 numShared; //number of the query's trigrams that the item also has
+	r32 score; //Dice coefficient of the two trigram sets, 1.0 means the item has exactly the query's trigrams
+};
+
+// An inverted index from each trigram (3 consecutive bytes of normalized text) to the items whose text contains it.
+// Items are identified by a small index chosen by the owner (SkillTree uses node indices) and each item has at most one piece of text.
+// Adding/removing an item only touches the posting lists of its own trigrams, and a search only walks the posting
+// lists of the query's trigrams, so neither one depends on the total number of items in the index
+typedef struct TrigramIndex TrigramIndex;
+struct TrigramIndex
+{
+	Arena* arena;
+	uxx numItems;
+	IdTable lookup; //trigram key -> index into postings
+	VarArray postings; //VarArray of u32 item indices (unsorted, each item shows up at most once per trigram)
+	VarArray itemNumTrigrams; //u32 (indexed by item index, 0 for items that aren't in the index)
+	VarArray itemSharedCounts; //u32 (indexed by item index, only non-zero while SearchTrigramIndex is running)
+};
+
+#endif //  _APP_TRIGRAM_INDEX_H
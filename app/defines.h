@@ -16,4 +16,18 @@ Date:   02\25\2025
 
 #define MAX_NODE_NAME_WIDTH 80 //px
 
+#define NODE_SEARCH_BOX_WIDTH    240 //px
+#define NODE_SEARCH_MAX_LENGTH   32 //bytes of UTF-8
+#define NODE_SEARCH_MAX_RESULTS  8
+
+#define STATS_PANEL_WIDTH        240 //px
+#define STATS_PANEL_MAX_DEGREES  8 //degrees past this are added up into one "N+" row
+
+#define SIMILAR_PANEL_WIDTH        240 //px
+#define SIMILAR_PANEL_MAX_RESULTS  5
+
+#define CHAIN_HIGHLIGHT_FRAME_BUDGET  16384 //references visited per frame while walking the hovered node's Dependency chains (or marking their branches if the reach index is current)
+
+#define TREE_UNDO_BUDGET  Kilobytes(64) //memory set aside for undo/redo history (see TreeUndoJournal)
+
 #endif //  _DEFINES_H
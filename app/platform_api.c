@@ -27,6 +27,86 @@ GET_NATIVE_WINDOW_HANDLE_DEF(Plat_GetNativeWindowHandle)
 	return result;
 }
 
+// +==============================+
+// |     Plat_QueueWorkerJob      |
+// +==============================+
+#if TARGET_IS_WINDOWS
+DWORD WINAPI Plat_WorkerThreadMain(LPVOID parameter)
+{
+	PlatformData* data = (PlatformData*)parameter;
+	while (true)
+	{
+		WaitForSingleObject(data->workerSignal, INFINITE);
+		PlatformWorkerJob job = data->workerJob;
+		job.function(job.contextPntr);
+	}
+	return 0;
+}
+#elif TARGET_IS_LINUX
+void* Plat_WorkerThreadMain(void* parameter)
+{
+	PlatformData* data = (PlatformData*)parameter;
+	while (true)
+	{
+		while (sem_wait(&data->workerSignal) != 0) { } //only fails if a signal interrupted the wait
+		PlatformWorkerJob job = data->workerJob;
+		job.function(job.contextPntr);
+	}
+	return nullptr;
+}
+#endif
+
+// The worker is never joined, it sleeps in its wait until the process exits
+void Plat_StartWorkerThread()
+{
+	Assert(!platformData->workerStarted && !platformData->workerFailed);
+	#if TARGET_IS_WINDOWS
+	{
+		platformData->workerSignal = CreateSemaphoreA(nullptr, 0, 1, nullptr);
+		if (platformData->workerSignal != NULL)
+		{
+			HANDLE threadHandle = CreateThread(nullptr, 0, Plat_WorkerThreadMain, platformData, 0, nullptr);
+			if (threadHandle != NULL)
+			{
+				CloseHandle(threadHandle);
+				platformData->workerStarted = true;
+			}
+			else { CloseHandle(platformData->workerSignal); }
+		}
+	}
+	#elif TARGET_IS_LINUX
+	{
+		if (sem_init(&platformData->workerSignal, 0, 0) == 0)
+		{
+			pthread_t threadId;
+			if (pthread_create(&threadId, nullptr, Plat_WorkerThreadMain, platformData) == 0)
+			{
+				pthread_detach(threadId);
+				platformData->workerStarted = true;
+			}
+			else { sem_destroy(&platformData->workerSignal); }
+		}
+	}
+	#endif
+	if (!platformData->workerStarted) { platformData->workerFailed = true; }
+}
+
+// bool Plat_QueueWorkerJob(const PlatformWorkerJob* job)
+QUEUE_WORKER_JOB_DEF(Plat_QueueWorkerJob)
+{
+	NotNull(job);
+	NotNull(job->function);
+	if (!platformData->workerStarted && !platformData->workerFailed) { Plat_StartWorkerThread(); }
+	if (!platformData->workerStarted) { return false; }
+	platformData->workerJob = *job;
+	#if TARGET_IS_WINDOWS
+	ReleaseSemaphore(platformData->workerSignal, 1, nullptr);
+	#elif TARGET_IS_LINUX
+	sem_post(&platformData->workerSignal);
+	#endif
+	return true;
+}
+
 #if BUILD_WITH_SOKOL_APP
 
 // +==============================+
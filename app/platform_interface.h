@@ -44,6 +44,23 @@ struct AppInput
 #define GET_NATIVE_WINDOW_HANDLE_DEF(functionName) const void* functionName()
 typedef GET_NATIVE_WINDOW_HANDLE_DEF(GetNativeWindowHandle_f);
 
+#define PLATFORM_THREAD_FUNC_DEF(functionName) void functionName(void* contextPntr)
+typedef PLATFORM_THREAD_FUNC_DEF(PlatformThreadFunc_f);
+
+typedef struct PlatformWorkerJob PlatformWorkerJob;
+struct PlatformWorkerJob
+{
+	PlatformThreadFunc_f* function;
+	void* contextPntr;
+};
+
+// Hands the job to the platform's worker thread. The thread is started by the first job and sleeps until it's signalled again after that,
+// so there's one thread for the whole program rather than one per job. The worker holds one job at a time (it's copied, the caller
+// doesn't have to keep it around) so a job has to signal that it's done itself, and the next one can't be queued before that.
+// Returns false if there is no worker (the TARGET doesn't have threads or it couldn't be started), the caller should do the work itself then
+#define QUEUE_WORKER_JOB_DEF(functionName) bool functionName(const PlatformWorkerJob* job)
+typedef QUEUE_WORKER_JOB_DEF(QueueWorkerJob_f);
+
 #if BUILD_WITH_SOKOL_APP
 #define GET_SOKOL_SWAPCHAIN_DEF(functionName) sg_swapchain functionName()
 typedef GET_SOKOL_SWAPCHAIN_DEF(GetSokolSwapchain_f);
@@ -65,6 +82,7 @@ typedef struct PlatformApi PlatformApi;
 struct PlatformApi
 {
 	GetNativeWindowHandle_f* GetNativeWindowHandle;
+	QueueWorkerJob_f* QueueWorkerJob;
 	#if BUILD_WITH_SOKOL_APP
 	GetSokolSwapchain_f* GetSokolSwapchain;
 	SetMouseLocked_f* SetMouseLocked;
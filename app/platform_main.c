@@ -45,6 +45,11 @@ Description:
 #include "misc/misc_sokol_app_helpers.c"
 #endif
 
+#if TARGET_IS_LINUX
+#include <pthread.h>
+#include <semaphore.h>
+#endif
+
 #define ENABLE_RAYLIB_LOGS_DEBUG   0
 #define ENABLE_RAYLIB_LOGS_INFO    0
 #define ENABLE_RAYLIB_LOGS_WARNING 1
@@ -223,6 +228,7 @@ int main()
 	NotNull(platform);
 	ClearPointer(platform);
 	platform->GetNativeWindowHandle = Plat_GetNativeWindowHandle;
+	platform->QueueWorkerJob = Plat_QueueWorkerJob;
 	#if BUILD_WITH_SOKOL_APP
 	platform->GetSokolSwapchain = Plat_GetSokolSwapchain;
 	platform->SetMouseLocked = Plat_SetMouseLocked;
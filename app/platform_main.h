@@ -22,6 +22,16 @@ struct PlatformData
 	AppInput appInputs[2];
 	AppInput* oldAppInput;
 	AppInput* currentAppInput;
+	
+	// The thread behind Plat_QueueWorkerJob, started by the first job
+	bool workerStarted;
+	bool workerFailed; //we don't try again after the first failure, every job runs on the calling thread
+	PlatformWorkerJob workerJob; //written before workerSignal is signalled, the worker copies it after it wakes up
+	#if TARGET_IS_WINDOWS
+	HANDLE workerSignal; //semaphore
+	#elif TARGET_IS_LINUX
+	sem_t workerSignal;
+	#endif
 };
 
 #endif //  _PLATFORM_MAIN_H
@@ -114,9 +114,10 @@ set common_cl_flags=%common_cl_flags% /I"%root%" /I"%app%" /I"%core%"
 :: -I = Add directory to the end of the list of include search paths
 :: -lm = Include the math library (required for stuff like sinf, atan, etc.)
 :: -ldl = Needed for dlopen and similar functions
+:: -pthread = Needed for pthread_create and sem_init (see Plat_StartWorkerThread)
 :: -mssse3 = For MeowHash to work we need sse3 support
 :: -maes = For MeowHash to work we need aes support
-set linux_clang_flags=-lm -ldl -L "." -I "../%root%" -I "../%app%" -I "../%core%" -mssse3 -maes
+set linux_clang_flags=-lm -ldl -pthread -L "." -I "../%root%" -I "../%app%" -I "../%core%" -mssse3 -maes
 if "%DEBUG_BUILD%"=="1" (
 	REM /MDd = ?
 	REM /Od = Optimization level: Debug